@@ -1,5 +1,6 @@
 use std::cell::{Cell, Ref, RefCell, RefMut};
 use std::ffi::{CStr, CString};
+use std::mem;
 use std::ops;
 use std::path::PathBuf;
 use std::ptr;
@@ -33,8 +34,9 @@ use glib::types::instance_of;
 use gobject_sys::{GEnumValue, GFlagsValue};
 
 use rsvg_internals::{
-    rsvg_log, DefsLookupErrorKind, Handle, IntrinsicDimensions, LoadOptions, LoadingError,
-    RenderingError, RsvgLength, SharedImageSurface, SurfaceType, ViewBox,
+    rsvg_log, DefsLookupErrorKind, Handle, HandlePushParser, IntrinsicDimensions, LoadOptions,
+    LoadingError, RenderStats, RenderingError, RsvgLength, SharedImageSurface, SurfaceType,
+    ViewBox,
 };
 
 use crate::dpi::Dpi;
@@ -54,6 +56,7 @@ mod handle_flags {
             const NONE            = 0;
             const UNLIMITED       = 1 << 0;
             const KEEP_IMAGE_DATA = 1 << 1;
+            const CACHE_DOCUMENT  = 1 << 2;
         }
     }
 
@@ -102,6 +105,7 @@ mod handle_flags {
 struct LoadFlags {
     pub unlimited_size: bool,
     pub keep_image_data: bool,
+    pub cache_document: bool,
 }
 
 pub use self::handle_flags::*;
@@ -111,6 +115,7 @@ impl From<HandleFlags> for LoadFlags {
         LoadFlags {
             unlimited_size: hflags.contains(HandleFlags::UNLIMITED),
             keep_image_data: hflags.contains(HandleFlags::KEEP_IMAGE_DATA),
+            cache_document: hflags.contains(HandleFlags::CACHE_DOCUMENT),
         }
     }
 }
@@ -127,6 +132,10 @@ impl From<LoadFlags> for HandleFlags {
             hflags.insert(HandleFlags::KEEP_IMAGE_DATA);
         }
 
+        if lflags.cache_document {
+            hflags.insert(HandleFlags::CACHE_DOCUMENT);
+        }
+
         hflags
     }
 }
@@ -151,8 +160,13 @@ enum LoadState {
     // Just created the CHandle
     Start,
 
-    // Being loaded using the legacy write()/close() API
-    Loading { buffer: Vec<u8> },
+    // Being loaded using the legacy write()/close() API; the bytes are being
+    // fed straight into the XML push parser as they arrive.
+    Loading { parser: HandlePushParser },
+
+    // Like Loading, but the data turned out to be compressed, which the push
+    // parser cannot handle; buffer everything and parse at close() time.
+    LoadingCompressed { buffer: Vec<u8> },
 
     ClosedOk { handle: Handle },
 
@@ -225,6 +239,30 @@ impl From<RsvgRectangle> for cairo::Rectangle {
     }
 }
 
+#[derive(Default, Clone, Copy, Debug, PartialEq)]
+#[repr(C)]
+pub struct RsvgRenderStats {
+    pub nodes_rendered: libc::size_t,
+    pub elements_referenced: libc::size_t,
+    pub filter_primitives: libc::size_t,
+    pub temporary_surface_bytes: libc::size_t,
+    pub filter_seconds: f64,
+    pub render_seconds: f64,
+}
+
+impl From<RenderStats> for RsvgRenderStats {
+    fn from(s: RenderStats) -> RsvgRenderStats {
+        RsvgRenderStats {
+            nodes_rendered: s.nodes_rendered,
+            elements_referenced: s.elements_referenced,
+            filter_primitives: s.filter_primitives,
+            temporary_surface_bytes: s.temporary_surface_bytes,
+            filter_seconds: s.filter_elapsed,
+            render_seconds: s.render_elapsed,
+        }
+    }
+}
+
 impl From<ViewBox> for RsvgRectangle {
     fn from(vb: ViewBox) -> RsvgRectangle {
         RsvgRectangle {
@@ -660,6 +698,7 @@ impl CHandle {
         LoadOptions::new(inner.base_url.get().map(|u| (*u).clone()))
             .with_unlimited_size(inner.load_flags.unlimited_size)
             .keep_image_data(inner.load_flags.keep_image_data)
+            .cache_document(inner.load_flags.cache_document)
     }
 
     fn set_size_callback(
@@ -672,23 +711,60 @@ impl CHandle {
         inner.size_callback = SizeCallback::new(size_func, user_data, destroy_notify);
     }
 
-    fn write(&self, buf: &[u8]) {
+    fn write(&self, buf: &[u8]) -> Result<(), LoadingError> {
         let mut state = self.load_state.borrow_mut();
 
         match *state {
             LoadState::Start => {
-                *state = LoadState::Loading {
-                    buffer: Vec::from(buf),
+                if buf.is_empty() {
+                    return Ok(());
+                }
+
+                // The push parser cannot handle compressed data, so check for
+                // the gzip magic number and fall back to buffering in that
+                // case.  An initial chunk of a single 0x1f byte could still
+                // turn out to be either; buffering is always correct, so take
+                // the fallback then, too.
+                if buf[0] == 0x1f && (buf.len() < 2 || buf[1] == 0x8b) {
+                    *state = LoadState::LoadingCompressed {
+                        buffer: Vec::from(buf),
+                    };
+                    return Ok(());
                 }
+
+                let parser = HandlePushParser::new(&self.load_options())?;
+
+                match parser.write(buf) {
+                    Ok(()) => {
+                        *state = LoadState::Loading { parser };
+                        Ok(())
+                    }
+
+                    Err(e) => {
+                        *state = LoadState::ClosedError;
+                        Err(e)
+                    }
+                }
+            }
+
+            LoadState::Loading { ref parser } => {
+                let res = parser.write(buf);
+
+                if res.is_err() {
+                    *state = LoadState::ClosedError;
+                }
+
+                res
             }
 
-            LoadState::Loading { ref mut buffer } => {
+            LoadState::LoadingCompressed { ref mut buffer } => {
                 buffer.extend_from_slice(buf);
+                Ok(())
             }
 
             _ => {
                 rsvg_g_critical("Handle must not be closed in order to write to it");
-                return;
+                Err(LoadingError::Unknown)
             }
         }
     }
@@ -696,21 +772,32 @@ impl CHandle {
     fn close(&self) -> Result<(), LoadingError> {
         let mut state = self.load_state.borrow_mut();
 
-        match *state {
-            LoadState::Start => {
-                *state = LoadState::ClosedError;
-                Err(LoadingError::NoDataPassedToParser)
-            }
+        match mem::replace(&mut *state, LoadState::ClosedError) {
+            LoadState::Start => Err(LoadingError::NoDataPassedToParser),
+
+            LoadState::Loading { parser } => match parser.close() {
+                Ok(handle) => {
+                    *state = LoadState::ClosedOk { handle };
+                    Ok(())
+                }
 
-            LoadState::Loading { ref buffer } => {
-                let bytes = Bytes::from(&*buffer);
+                // the state is already ClosedError
+                Err(e) => Err(e),
+            },
+
+            LoadState::LoadingCompressed { buffer } => {
+                let bytes = Bytes::from(&buffer[..]);
                 let stream = gio::MemoryInputStream::new_from_bytes(&bytes);
 
                 self.read_stream(state, &stream.upcast(), None)
             }
 
             // Closing is idempotent
-            LoadState::ClosedOk { .. } => Ok(()),
+            closed @ LoadState::ClosedOk { .. } => {
+                *state = closed;
+                Ok(())
+            }
+
             LoadState::ClosedError => Ok(()),
         }
     }
@@ -724,7 +811,10 @@ impl CHandle {
 
         match *state {
             LoadState::Start => self.read_stream(state, stream, cancellable),
-            LoadState::Loading { .. } | LoadState::ClosedOk { .. } | LoadState::ClosedError => {
+            LoadState::Loading { .. }
+            | LoadState::LoadingCompressed { .. }
+            | LoadState::ClosedOk { .. }
+            | LoadState::ClosedError => {
                 rsvg_g_critical(
                     "handle must not be already loaded in order to call \
                      rsvg_handle_read_stream_sync()",
@@ -753,6 +843,64 @@ impl CHandle {
         }
     }
 
+    fn load_from_cache_or_file(
+        &self,
+        file: &gio::File,
+        cache_path: &PathBuf,
+    ) -> Result<(), LoadingError> {
+        let mut load_state = self.load_state.borrow_mut();
+
+        match *load_state {
+            LoadState::Start => (),
+            _ => {
+                rsvg_g_critical(
+                    "handle must not be already loaded in order to call \
+                     rsvg_handle_new_from_cache_file()",
+                );
+                return Err(LoadingError::Unknown);
+            }
+        }
+
+        if let Ok(cache_data) = std::fs::read(cache_path) {
+            match Handle::from_cache_data(&self.load_options(), &cache_data) {
+                Ok(handle) => {
+                    *load_state = LoadState::ClosedOk { handle };
+                    return Ok(());
+                }
+
+                Err(e) => {
+                    // Stale or mismatched cache; fall back to the XML parser below and
+                    // regenerate the cache file.
+                    rsvg_log!(
+                        "could not load pre-parsed cache {:?} ({}); parsing the XML instead",
+                        cache_path,
+                        e
+                    );
+                }
+            }
+        }
+
+        let stream = file.read(None::<&gio::Cancellable>)?;
+
+        match Handle::from_stream_and_record(&self.load_options(), &stream.upcast(), None) {
+            Ok((handle, cache_data)) => {
+                // Writing the cache is best-effort; a read-only location just means the
+                // next load parses the XML again.
+                if let Err(e) = std::fs::write(cache_path, &cache_data) {
+                    rsvg_log!("could not write pre-parsed cache {:?}: {}", cache_path, e);
+                }
+
+                *load_state = LoadState::ClosedOk { handle };
+                Ok(())
+            }
+
+            Err(e) => {
+                *load_state = LoadState::ClosedError;
+                Err(e)
+            }
+        }
+    }
+
     fn get_handle_ref(&self) -> Result<Ref<Handle>, RenderingError> {
         let state = self.load_state.borrow();
 
@@ -762,7 +910,7 @@ impl CHandle {
                 Err(RenderingError::HandleIsNotLoaded)
             }
 
-            LoadState::Loading { .. } => {
+            LoadState::Loading { .. } | LoadState::LoadingCompressed { .. } => {
                 rsvg_g_critical("Handle is still loading; call rsvg_handle_close() first");
                 Err(RenderingError::HandleIsNotLoaded)
             }
@@ -922,6 +1070,31 @@ impl CHandle {
         pixbuf_from_surface(&surface)
     }
 
+    fn get_pixbuf_at_size(&self, width: i32, height: i32) -> Result<Pixbuf, RenderingError> {
+        let dimensions = self.get_dimensions_sub(None)?;
+
+        if dimensions.width == 0 || dimensions.height == 0 {
+            return empty_pixbuf();
+        }
+
+        // Render directly at the requested size instead of rendering at the document
+        // size and scaling the resulting pixbuf.
+        let surface = cairo::ImageSurface::create(cairo::Format::ARgb32, width, height)?;
+
+        {
+            let cr = cairo::Context::new(&surface);
+            cr.scale(
+                f64::from(width) / f64::from(dimensions.width),
+                f64::from(height) / f64::from(dimensions.height),
+            );
+            self.render_cairo_sub(&cr, None)?;
+        }
+
+        let surface = SharedImageSurface::wrap(surface, SurfaceType::SRgb)?;
+
+        pixbuf_from_surface(&surface)
+    }
+
     fn render_document(
         &self,
         cr: &cairo::Context,
@@ -934,6 +1107,19 @@ impl CHandle {
         handle.render_document(cr, viewport, inner.dpi.into(), inner.is_testing)
     }
 
+    fn render_document_tiled(
+        &self,
+        cr: &cairo::Context,
+        viewport: &cairo::Rectangle,
+        tile_size: u32,
+    ) -> Result<(), RenderingError> {
+        check_cairo_context(cr)?;
+
+        let handle = self.get_handle_ref()?;
+        let inner = self.inner.borrow();
+        handle.render_document_tiled(cr, viewport, tile_size, inner.dpi.into(), inner.is_testing)
+    }
+
     fn get_geometry_for_layer(
         &self,
         id: Option<&str>,
@@ -994,6 +1180,11 @@ impl CHandle {
         Ok(handle.get_intrinsic_dimensions())
     }
 
+    fn get_render_stats(&self) -> Result<RenderStats, RenderingError> {
+        let handle = self.get_handle_ref()?;
+        Ok(handle.render_stats())
+    }
+
     fn set_testing(&self, is_testing: bool) {
         let mut inner = self.inner.borrow_mut();
         inner.is_testing = is_testing;
@@ -1075,7 +1266,7 @@ pub unsafe extern "C" fn rsvg_rust_handle_flags_get_type() -> glib_sys::GType {
     struct GFlagsValueWrapper(GFlagsValue);
     unsafe impl Sync for GFlagsValueWrapper {}
 
-    static VALUES: [GFlagsValueWrapper; 4] = [
+    static VALUES: [GFlagsValueWrapper; 5] = [
         GFlagsValueWrapper(GFlagsValue {
             value: 0, // handle_flags::HandleFlags::NONE.bits(),
             value_name: b"RSVG_HANDLE_FLAGS_NONE\0" as *const u8 as *const _,
@@ -1091,6 +1282,11 @@ pub unsafe extern "C" fn rsvg_rust_handle_flags_get_type() -> glib_sys::GType {
             value_name: b"RSVG_HANDLE_FLAG_KEEP_IMAGE_DATA\0" as *const u8 as *const _,
             value_nick: b"flag-keep-image-data\0" as *const u8 as *const _,
         }),
+        GFlagsValueWrapper(GFlagsValue {
+            value: 1 << 2, // HandleFlags::CACHE_DOCUMENT.to_glib(),
+            value_name: b"RSVG_HANDLE_FLAG_CACHE_DOCUMENT\0" as *const u8 as *const _,
+            value_nick: b"flag-cache-document\0" as *const u8 as *const _,
+        }),
         GFlagsValueWrapper(GFlagsValue {
             value: 0,
             value_name: 0 as *const _,
@@ -1263,9 +1459,15 @@ pub unsafe extern "C" fn rsvg_rust_handle_write(
 
     let rhandle = get_rust_handle(handle);
     let buffer = slice::from_raw_parts(buf, count);
-    rhandle.write(buffer);
 
-    true.to_glib()
+    match rhandle.write(buffer) {
+        Ok(()) => true.to_glib(),
+
+        Err(e) => {
+            set_gerror(error, 0, &format!("{}", e));
+            false.to_glib()
+        }
+    }
 }
 
 #[no_mangle]
@@ -1362,6 +1564,31 @@ pub unsafe extern "C" fn rsvg_rust_handle_get_pixbuf_sub(
     }
 }
 
+#[no_mangle]
+pub unsafe extern "C" fn rsvg_rust_handle_get_pixbuf_at_size(
+    handle: *const RsvgHandle,
+    width: libc::c_int,
+    height: libc::c_int,
+) -> *mut gdk_pixbuf_sys::GdkPixbuf {
+    rsvg_return_val_if_fail! {
+        rsvg_handle_get_pixbuf_at_size => ptr::null_mut();
+
+        is_rsvg_handle(handle),
+        width > 0,
+        height > 0,
+    }
+
+    let rhandle = get_rust_handle(handle);
+
+    match rhandle.get_pixbuf_at_size(width, height) {
+        Ok(pixbuf) => pixbuf.to_glib_full(),
+        Err(e) => {
+            rsvg_log!("could not render: {}", e);
+            ptr::null_mut()
+        }
+    }
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn rsvg_rust_handle_get_dimensions(
     handle: *const RsvgHandle,
@@ -1472,6 +1699,51 @@ pub unsafe extern "C" fn rsvg_rust_handle_new_from_file(
     rsvg_rust_handle_new_from_gfile_sync(file.to_glib_none().0, 0, ptr::null_mut(), error)
 }
 
+#[no_mangle]
+pub unsafe extern "C" fn rsvg_rust_handle_new_from_cache_file(
+    filename: *const libc::c_char,
+    cache_filename: *const libc::c_char,
+    error: *mut *mut glib_sys::GError,
+) -> *const RsvgHandle {
+    rsvg_return_val_if_fail! {
+        rsvg_handle_new_from_cache_file => ptr::null();
+
+        !filename.is_null(),
+        !cache_filename.is_null(),
+        error.is_null() || (*error).is_null(),
+    }
+
+    let file = match PathOrUrl::new(filename) {
+        Ok(PathOrUrl::Path(path)) => gio::File::new_for_path(path),
+
+        Ok(PathOrUrl::Url(url)) => gio::File::new_for_uri(url.as_str()),
+
+        Err(e) => {
+            set_gerror(error, 0, &format!("{}", e));
+            return ptr::null_mut();
+        }
+    };
+
+    let cache_path = PathBuf::from(
+        String::from_utf8_lossy(CStr::from_ptr(cache_filename).to_bytes()).to_string(),
+    );
+
+    let raw_handle = rsvg_rust_handle_new_with_flags(0);
+    let rhandle = get_rust_handle(raw_handle);
+
+    rhandle.set_base_gfile(&file);
+
+    match rhandle.load_from_cache_or_file(&file, &cache_path) {
+        Ok(()) => raw_handle,
+
+        Err(e) => {
+            set_gerror(error, 0, &format!("{}", e));
+            gobject_sys::g_object_unref(raw_handle as *mut _);
+            ptr::null_mut()
+        }
+    }
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn rsvg_rust_handle_new_from_gfile_sync(
     file: *mut gio_sys::GFile,
@@ -1684,6 +1956,27 @@ pub unsafe extern "C" fn rsvg_rust_handle_get_intrinsic_dimensions(
     set_out_param(out_has_viewbox, out_viewbox, &r);
 }
 
+#[no_mangle]
+pub unsafe extern "C" fn rsvg_rust_handle_get_render_stats(
+    handle: *const RsvgHandle,
+    out_stats: *mut RsvgRenderStats,
+) {
+    rsvg_return_if_fail! {
+        rsvg_handle_get_render_stats;
+
+        is_rsvg_handle(handle),
+        !out_stats.is_null(),
+    }
+
+    let rhandle = get_rust_handle(handle);
+
+    let stats = rhandle
+        .get_render_stats()
+        .unwrap_or_else(|_| RenderStats::default());
+
+    *out_stats = RsvgRenderStats::from(stats);
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn rsvg_rust_handle_render_document(
     handle: *const RsvgHandle,
@@ -1713,6 +2006,36 @@ pub unsafe extern "C" fn rsvg_rust_handle_render_document(
     }
 }
 
+#[no_mangle]
+pub unsafe extern "C" fn rsvg_rust_handle_render_document_tiled(
+    handle: *const RsvgHandle,
+    cr: *mut cairo_sys::cairo_t,
+    viewport: *const RsvgRectangle,
+    tile_size: libc::c_uint,
+    error: *mut *mut glib_sys::GError,
+) -> glib_sys::gboolean {
+    rsvg_return_val_if_fail! {
+        rsvg_handle_render_document_tiled => false.to_glib();
+
+        is_rsvg_handle(handle),
+        !cr.is_null(),
+        !viewport.is_null(),
+        error.is_null() || (*error).is_null(),
+    }
+
+    let rhandle = get_rust_handle(handle);
+    let cr = from_glib_none(cr);
+
+    match rhandle.render_document_tiled(&cr, &(*viewport).into(), tile_size) {
+        Ok(()) => true.to_glib(),
+
+        Err(e) => {
+            set_gerror(error, 0, &format!("{}", e));
+            false.to_glib()
+        }
+    }
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn rsvg_rust_handle_get_geometry_for_layer(
     handle: *mut RsvgHandle,
@@ -44,6 +44,25 @@ gboolean rsvg_handle_render_document (RsvgHandle           *handle,
                                       const RsvgRectangle  *viewport,
                                       GError              **error);
 
+RSVG_API
+void rsvg_handle_render_document_async (RsvgHandle           *handle,
+                                        const RsvgRectangle  *viewport,
+                                        GCancellable         *cancellable,
+                                        GAsyncReadyCallback   callback,
+                                        gpointer              user_data);
+
+RSVG_API
+cairo_surface_t *rsvg_handle_render_document_finish (RsvgHandle    *handle,
+                                                     GAsyncResult  *result,
+                                                     GError       **error);
+
+RSVG_API
+gboolean rsvg_handle_render_document_tiled (RsvgHandle           *handle,
+                                            cairo_t              *cr,
+                                            const RsvgRectangle  *viewport,
+                                            guint                 tile_size,
+                                            GError              **error);
+
 RSVG_API
 gboolean rsvg_handle_get_geometry_for_layer (RsvgHandle     *handle,
                                              const char     *id,
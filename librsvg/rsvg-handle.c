@@ -316,6 +316,7 @@
 
 #include <string.h>
 #include <limits.h>
+#include <math.h>
 #include <stdlib.h>
 #include <glib/gprintf.h>
 #include <glib/gi18n-lib.h>
@@ -339,6 +340,9 @@ extern gboolean rsvg_rust_handle_render_cairo_sub (RsvgHandle *handle,
                                                    cairo_t *cr,
                                                    const char *id);
 extern GdkPixbuf *rsvg_rust_handle_get_pixbuf_sub (RsvgHandle *handle, const char *id);
+extern GdkPixbuf *rsvg_rust_handle_get_pixbuf_at_size (RsvgHandle *handle,
+                                                       int         width,
+                                                       int         height);
 extern void rsvg_rust_handle_get_dimensions (RsvgHandle *handle,
                                              RsvgDimensionData *dimension_data);
 extern gboolean rsvg_rust_handle_get_dimensions_sub (RsvgHandle *handle,
@@ -354,6 +358,9 @@ extern void rsvg_rust_handle_set_size_callback (RsvgHandle *raw_handle,
 extern RsvgHandle *rsvg_rust_handle_new_with_flags (RsvgHandleFlags flags);
 extern RsvgHandle *rsvg_rust_handle_new_from_file (const char *filename,
                                                    GError **error);
+extern RsvgHandle *rsvg_rust_handle_new_from_cache_file (const char *filename,
+                                                         const char *cache_filename,
+                                                         GError **error);
 extern RsvgHandle *rsvg_rust_handle_new_from_gfile_sync (GFile *file,
                                                          RsvgHandleFlags flags,
                                                          GCancellable *cancellable,
@@ -378,10 +385,17 @@ extern void rsvg_rust_handle_get_intrinsic_dimensions (RsvgHandle *handle,
                                                        RsvgLength *out_height,
                                                        gboolean   *out_has_viewbox,
                                                        RsvgRectangle *out_viewbox);
+extern void rsvg_rust_handle_get_render_stats (RsvgHandle      *handle,
+                                               RsvgRenderStats *stats);
 extern gboolean rsvg_rust_handle_render_document (RsvgHandle           *handle,
                                                   cairo_t              *cr,
                                                   const RsvgRectangle  *viewport,
                                                   GError              **error);
+extern gboolean rsvg_rust_handle_render_document_tiled (RsvgHandle           *handle,
+                                                        cairo_t              *cr,
+                                                        const RsvgRectangle  *viewport,
+                                                        guint                 tile_size,
+                                                        GError              **error);
 extern gboolean rsvg_rust_handle_get_geometry_for_layer (RsvgHandle     *handle,
                                                          const char     *id,
                                                          const RsvgRectangle *viewport,
@@ -503,6 +517,30 @@ rsvg_handle_new_from_file (const gchar *filename, GError **error)
     return rsvg_rust_handle_new_from_file (filename, error);
 }
 
+/**
+ * rsvg_handle_new_from_cache_file:
+ * @filename: The SVG file name to load, or a URI.
+ * @cache_filename: Path of the pre-parsed cache file for @filename.
+ * @error: (optional): return location for errors
+ *
+ * Loads the SVG specified by @filename, using @cache_filename to avoid re-parsing
+ * the XML when possible.  If @cache_filename exists and was written by a compatible
+ * version of librsvg, the document is loaded from it directly.  Otherwise the SVG
+ * is parsed normally and the cache file is (re)written, so subsequent loads of the
+ * same document become I/O-bound instead of parse-bound.
+ *
+ * The cache file is a private, version-checked format; it is invalidated
+ * automatically when the format changes between librsvg versions.
+ *
+ * Returns: A #RsvgHandle or %NULL if an error occurs.
+ * Since: 2.50
+ */
+RsvgHandle *
+rsvg_handle_new_from_cache_file (const gchar *filename, const gchar *cache_filename, GError **error)
+{
+    return rsvg_rust_handle_new_from_cache_file (filename, cache_filename, error);
+}
+
 /**
  * rsvg_handle_new_with_flags:
  * @flags: flags from #RsvgHandleFlags
@@ -604,14 +642,19 @@ rsvg_handle_new_from_stream_sync (GInputStream    *input_stream,
  * <literal>&lt;image&gt;</literal> which reference external resources will be
  * resolved relative to the location you specify with those functions.
  *
+ * Each chunk is fed straight into the XML parser, so parsing overlaps with
+ * whatever produces the data, and a document that is not well-formed can make
+ * this function return %FALSE as soon as the offending chunk is written,
+ * before the rest of the data has been transferred.  Compressed (SVGZ) data
+ * cannot be parsed incrementally; it gets accumulated in memory and parsed
+ * when rsvg_handle_close() is called.
+ *
  * Returns: %TRUE on success, or %FALSE on error.
  *
  * Deprecated: 2.46.  Use rsvg_handle_read_stream_sync() or the constructor
  * functions rsvg_handle_new_from_gfile_sync() or
- * rsvg_handle_new_from_stream_sync().  This function is deprecated because it
- * will accumlate data from the @buf in memory until rsvg_handle_close() gets
- * called.  To avoid a big temporary buffer, use the suggested funtions, which
- * take a #GFile or a #GInputStream and do not require a temporary buffer.
+ * rsvg_handle_new_from_stream_sync(), which take a #GFile or a #GInputStream
+ * and can also report I/O errors.
  **/
 gboolean
 rsvg_handle_write (RsvgHandle *handle, const guchar *buf, gsize count, GError **error)
@@ -678,6 +721,85 @@ rsvg_handle_read_stream_sync (RsvgHandle   *handle,
                                               error);
 }
 
+static void
+read_stream_in_thread (GTask        *task,
+                       gpointer      source_object,
+                       gpointer      task_data,
+                       GCancellable *cancellable)
+{
+    RsvgHandle *handle = RSVG_HANDLE (source_object);
+    GInputStream *stream = G_INPUT_STREAM (task_data);
+    GError *error = NULL;
+
+    if (rsvg_handle_read_stream_sync (handle, stream, cancellable, &error))
+        g_task_return_boolean (task, TRUE);
+    else
+        g_task_return_error (task, error);
+}
+
+/**
+ * rsvg_handle_read_stream_async:
+ * @handle: a #RsvgHandle
+ * @stream: a #GInputStream
+ * @cancellable: (nullable): a #GCancellable, or %NULL
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the stream has
+ *   been read
+ * @user_data: data to pass to @callback
+ *
+ * Asynchronous version of rsvg_handle_read_stream_sync().  The stream is read
+ * and parsed in a worker thread, so the calling thread's main loop is not
+ * blocked; @callback is invoked when the operation finishes.  Call
+ * rsvg_handle_read_stream_finish() from @callback to obtain the result.
+ *
+ * The @handle must not be used from other threads while the operation is in
+ * progress.
+ *
+ * Since: 2.50
+ */
+void
+rsvg_handle_read_stream_async (RsvgHandle          *handle,
+                               GInputStream        *stream,
+                               GCancellable        *cancellable,
+                               GAsyncReadyCallback  callback,
+                               gpointer             user_data)
+{
+    GTask *task;
+
+    g_return_if_fail (RSVG_IS_HANDLE (handle));
+    g_return_if_fail (G_IS_INPUT_STREAM (stream));
+    g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+    task = g_task_new (handle, cancellable, callback, user_data);
+    g_task_set_source_tag (task, rsvg_handle_read_stream_async);
+    g_task_set_task_data (task, g_object_ref (stream), g_object_unref);
+    g_task_run_in_thread (task, read_stream_in_thread);
+    g_object_unref (task);
+}
+
+/**
+ * rsvg_handle_read_stream_finish:
+ * @handle: a #RsvgHandle
+ * @result: a #GAsyncResult
+ * @error: (optional): a location to store a #GError, or %NULL
+ *
+ * Finishes an operation started with rsvg_handle_read_stream_async().
+ *
+ * Returns: %TRUE if reading the stream succeeded, or %FALSE otherwise
+ *   with @error filled in
+ *
+ * Since: 2.50
+ */
+gboolean
+rsvg_handle_read_stream_finish (RsvgHandle    *handle,
+                                GAsyncResult  *result,
+                                GError       **error)
+{
+    g_return_val_if_fail (RSVG_IS_HANDLE (handle), FALSE);
+    g_return_val_if_fail (g_task_is_valid (result, handle), FALSE);
+
+    return g_task_propagate_boolean (G_TASK (result), error);
+}
+
 /**
  * rsvg_handle_set_base_uri:
  * @handle: A #RsvgHandle
@@ -1037,6 +1159,31 @@ rsvg_handle_get_pixbuf (RsvgHandle *handle)
     return rsvg_handle_get_pixbuf_sub (handle, NULL);
 }
 
+/**
+ * rsvg_handle_get_pixbuf_at_size:
+ * @handle: An #RsvgHandle
+ * @width: desired width of the pixbuf, in pixels
+ * @height: desired height of the pixbuf, in pixels
+ *
+ * Renders the loaded SVG directly at the requested size and returns the result
+ * as a pixbuf.  Unlike calling rsvg_handle_get_pixbuf() and scaling the result,
+ * this renders the document at the target size, so it is both faster and
+ * produces sharper output when thumbnailing.
+ *
+ * The document is scaled non-proportionally to fill the requested size; pass
+ * dimensions with the document's aspect ratio to preserve it.
+ *
+ * Returns: (transfer full) (nullable): a pixbuf of @width x @height pixels, or
+ * %NULL if an error occurs during rendering.
+ *
+ * Since: 2.50
+ **/
+GdkPixbuf *
+rsvg_handle_get_pixbuf_at_size (RsvgHandle *handle, int width, int height)
+{
+    return rsvg_rust_handle_get_pixbuf_at_size (handle, width, height);
+}
+
 /**
  * rsvg_handle_set_dpi:
  * @handle: An #RsvgHandle
@@ -1209,6 +1356,35 @@ rsvg_handle_get_intrinsic_dimensions (RsvgHandle *handle,
                                                out_viewbox);
 }
 
+/**
+ * rsvg_handle_get_render_stats:
+ * @handle: An #RsvgHandle
+ * @stats: (out): a location to store an #RsvgRenderStats
+ *
+ * Queries the instrumentation counters accumulated by the most recent
+ * rendering done through @handle, for example with rsvg_handle_render_cairo()
+ * or rsvg_handle_render_document().
+ *
+ * This is meant for attributing rendering cost to particular documents without
+ * running a profiler: the counters say how many nodes were drawn, how many
+ * element references were resolved, how many filter primitives ran, how much
+ * temporary surface memory was needed, and how the wall-clock time of the pass
+ * splits between filters and everything else.
+ *
+ * If @handle has not rendered anything yet, all the counters are zero.  Note
+ * that renders which only replay librsvg's retained display list do not
+ * re-render the scene; in that case the stats keep describing the pass that
+ * recorded the display list.
+ *
+ * Since: 2.50
+ */
+void
+rsvg_handle_get_render_stats (RsvgHandle      *handle,
+                              RsvgRenderStats *stats)
+{
+    rsvg_rust_handle_get_render_stats (handle, stats);
+}
+
 /**
  * rsvg_handle_render_document:
  * @handle: An #RsvgHandle
@@ -1240,6 +1416,139 @@ rsvg_handle_render_document (RsvgHandle           *handle,
     return rsvg_rust_handle_render_document (handle, cr, viewport, error);
 }
 
+static void
+render_document_in_thread (GTask        *task,
+                           gpointer      source_object,
+                           gpointer      task_data,
+                           GCancellable *cancellable)
+{
+    RsvgHandle *handle = RSVG_HANDLE (source_object);
+    RsvgRectangle *viewport = task_data;
+    cairo_surface_t *surface;
+    cairo_t *cr;
+    GError *error = NULL;
+    gboolean res;
+
+    surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+                                          (int) ceil (viewport->width),
+                                          (int) ceil (viewport->height));
+    cr = cairo_create (surface);
+
+    /* Render at the surface's origin regardless of the viewport position. */
+    cairo_translate (cr, -viewport->x, -viewport->y);
+
+    res = rsvg_handle_render_document (handle, cr, viewport, &error);
+    cairo_destroy (cr);
+
+    if (res) {
+        g_task_return_pointer (task, surface, (GDestroyNotify) cairo_surface_destroy);
+    } else {
+        cairo_surface_destroy (surface);
+        g_task_return_error (task, error);
+    }
+}
+
+/**
+ * rsvg_handle_render_document_async:
+ * @handle: An #RsvgHandle
+ * @viewport: Viewport size at which the whole SVG would be fitted.
+ * @cancellable: (nullable): a #GCancellable, or %NULL
+ * @callback: (scope async): a #GAsyncReadyCallback to call when rendering is done
+ * @user_data: data to pass to @callback
+ *
+ * Renders the whole SVG document fitted to a viewport into an image surface on
+ * a worker thread, so the calling thread's main loop is not blocked.  Call
+ * rsvg_handle_render_document_finish() from @callback to obtain the surface.
+ *
+ * The @handle must not be used from other threads while the operation is in
+ * progress.
+ *
+ * API ordering: This function must be called on a fully-loaded @handle.  See
+ * the section <ulink url="#API-ordering">API ordering</ulink> for details.
+ *
+ * Since: 2.50
+ */
+void
+rsvg_handle_render_document_async (RsvgHandle          *handle,
+                                   const RsvgRectangle *viewport,
+                                   GCancellable        *cancellable,
+                                   GAsyncReadyCallback  callback,
+                                   gpointer             user_data)
+{
+    GTask *task;
+
+    g_return_if_fail (RSVG_IS_HANDLE (handle));
+    g_return_if_fail (viewport != NULL);
+    g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+    task = g_task_new (handle, cancellable, callback, user_data);
+    g_task_set_source_tag (task, rsvg_handle_render_document_async);
+    g_task_set_task_data (task,
+                          g_memdup (viewport, sizeof (RsvgRectangle)),
+                          g_free);
+    g_task_run_in_thread (task, render_document_in_thread);
+    g_object_unref (task);
+}
+
+/**
+ * rsvg_handle_render_document_finish:
+ * @handle: An #RsvgHandle
+ * @result: a #GAsyncResult
+ * @error: (optional): a location to store a #GError, or %NULL
+ *
+ * Finishes an operation started with rsvg_handle_render_document_async().
+ *
+ * Returns: (transfer full) (nullable): an image surface with the rendered
+ *   document, to be freed with cairo_surface_destroy(), or %NULL on error with
+ *   @error filled in
+ *
+ * Since: 2.50
+ */
+cairo_surface_t *
+rsvg_handle_render_document_finish (RsvgHandle    *handle,
+                                    GAsyncResult  *result,
+                                    GError       **error)
+{
+    g_return_val_if_fail (RSVG_IS_HANDLE (handle), NULL);
+    g_return_val_if_fail (g_task_is_valid (result, handle), NULL);
+
+    return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/**
+ * rsvg_handle_render_document_tiled:
+ * @handle: An #RsvgHandle
+ * @cr: A Cairo context
+ * @viewport: Viewport size at which the whole SVG would be fitted.
+ * @tile_size: Size in pixels of the square tiles to render, or 0 to render
+ * everything in a single pass.
+ * @error: (optional): a location to store a #GError, or %NULL
+ *
+ * Renders the whole SVG document fitted to a viewport, one tile at a time.
+ *
+ * This is equivalent to rsvg_handle_render_document(), but the viewport is
+ * split into a grid of @tile_size×@tile_size squares, and each tile is
+ * rendered into its own temporary image surface before being composited onto
+ * @cr.  For very large viewports this keeps Cairo's working set bounded by
+ * the tile size instead of the whole canvas.
+ *
+ * API ordering: This function must be called on a fully-loaded @handle.  See
+ * the section <ulink url="#API-ordering">API ordering</ulink> for details.
+ *
+ * Panics: this function will panic if the @handle is not fully-loaded.
+ *
+ * Since: 2.50
+ */
+gboolean
+rsvg_handle_render_document_tiled (RsvgHandle           *handle,
+                                   cairo_t              *cr,
+                                   const RsvgRectangle  *viewport,
+                                   guint                 tile_size,
+                                   GError              **error)
+{
+    return rsvg_rust_handle_render_document_tiled (handle, cr, viewport, tile_size, error);
+}
+
 /**
  * rsvg_handle_get_geometry_for_layer:
  * @handle: An #RsvgHandle
@@ -195,6 +195,8 @@ RSVG_API
 GdkPixbuf   *rsvg_handle_get_pixbuf	(RsvgHandle *handle);
 RSVG_API
 GdkPixbuf   *rsvg_handle_get_pixbuf_sub (RsvgHandle *handle, const char *id);
+RSVG_API
+GdkPixbuf   *rsvg_handle_get_pixbuf_at_size (RsvgHandle *handle, int width, int height);
 
 RSVG_API
 const char  *rsvg_handle_get_base_uri (RsvgHandle *handle);
@@ -278,6 +280,35 @@ void rsvg_handle_get_intrinsic_dimensions (RsvgHandle *handle,
                                            gboolean   *out_has_viewbox,
                                            RsvgRectangle *out_viewbox);
 
+/**
+ * RsvgRenderStats:
+ * @nodes_rendered: number of nodes that were actually drawn.
+ * @elements_referenced: number of element references that were resolved, e.g.
+ *   through <literal>&lt;use&gt;</literal> or paint server lookups.
+ * @filter_primitives: number of filter primitives that were executed.
+ * @temporary_surface_bytes: bytes allocated for temporary surfaces (masks,
+ *   opacity groups, filter intermediates).
+ * @filter_seconds: seconds spent executing filter primitives.
+ * @render_seconds: seconds spent in the whole rendering pass, filters included.
+ *
+ * Counters accumulated during a rendering pass; see
+ * rsvg_handle_get_render_stats().
+ *
+ * Since: 2.50
+ */
+typedef struct {
+    gsize  nodes_rendered;
+    gsize  elements_referenced;
+    gsize  filter_primitives;
+    gsize  temporary_surface_bytes;
+    double filter_seconds;
+    double render_seconds;
+} RsvgRenderStats;
+
+RSVG_API
+void rsvg_handle_get_render_stats (RsvgHandle      *handle,
+                                   RsvgRenderStats *stats);
+
 /* GIO APIs */
 
 /**
@@ -300,12 +331,20 @@ void rsvg_handle_get_intrinsic_dimensions (RsvgHandle *handle,
  *  url="https://www.cairographics.org/manual/cairo-cairo-surface-t.html#cairo-surface-set-mime-data">the
  *  Cairo documentation</ulink> for details.
  *  Since: 2.40.3
+ * @RSVG_HANDLE_FLAG_CACHE_DOCUMENT: Share parsed document data with other
+ *  handles through a process-wide cache.  When a handle with this flag loads
+ *  a document whose contents were already parsed by another handle, the
+ *  cached pre-parsed form is reused instead of running the XML parser again.
+ *  The cache is keyed by the document's contents, so it is safe to use for
+ *  documents loaded from changing files; stale entries are simply missed.
+ *  Since: 2.50
  */
 typedef enum /*< flags >*/
 {
     RSVG_HANDLE_FLAGS_NONE           = 0,
     RSVG_HANDLE_FLAG_UNLIMITED       = 1 << 0,
-    RSVG_HANDLE_FLAG_KEEP_IMAGE_DATA = 1 << 1
+    RSVG_HANDLE_FLAG_KEEP_IMAGE_DATA = 1 << 1,
+    RSVG_HANDLE_FLAG_CACHE_DOCUMENT  = 1 << 2
 } RsvgHandleFlags;
 
 RSVG_API
@@ -325,6 +364,18 @@ gboolean    rsvg_handle_read_stream_sync (RsvgHandle   *handle,
                                           GCancellable *cancellable,
                                           GError      **error);
 
+RSVG_API
+void        rsvg_handle_read_stream_async (RsvgHandle          *handle,
+                                           GInputStream        *stream,
+                                           GCancellable        *cancellable,
+                                           GAsyncReadyCallback  callback,
+                                           gpointer             user_data);
+
+RSVG_API
+gboolean    rsvg_handle_read_stream_finish (RsvgHandle    *handle,
+                                            GAsyncResult  *result,
+                                            GError       **error);
+
 RSVG_API
 RsvgHandle *rsvg_handle_new_from_gfile_sync (GFile          *file,
                                              RsvgHandleFlags flags,
@@ -342,6 +393,10 @@ RSVG_API
 RsvgHandle *rsvg_handle_new_from_data (const guint8 *data, gsize data_len, GError **error);
 RSVG_API
 RsvgHandle *rsvg_handle_new_from_file (const gchar *filename, GError **error);
+RSVG_API
+RsvgHandle *rsvg_handle_new_from_cache_file (const gchar *filename,
+                                             const gchar *cache_filename,
+                                             GError     **error);
 
 RSVG_API
 gboolean rsvg_handle_set_stylesheet (RsvgHandle   *handle,
@@ -41,6 +41,7 @@
 #include <limits.h>
 #include <locale.h>
 #include <glib/gi18n.h>
+#include <glib/gstdio.h>
 #include <gio/gio.h>
 
 #ifdef G_OS_UNIX
@@ -203,7 +204,244 @@ get_lookup_id_from_command_line (const char *lookup_id)
 
     return export_lookup_id;
 }
- 
+
+static void
+build_size_mode (SizeMode *size_data,
+                 int width, int height,
+                 double x_zoom, double y_zoom,
+                 gboolean keep_aspect_ratio)
+{
+    /* if both are unspecified, assume user wants to zoom the image in at least 1 dimension */
+    if (width == -1 && height == -1) {
+        size_data->kind = SIZE_KIND_ZOOM;
+        size_data->x_zoom = x_zoom;
+        size_data->y_zoom = y_zoom;
+    } else if (x_zoom == 1.0 && y_zoom == 1.0) {
+        /* if one parameter is unspecified, assume user wants to keep the aspect ratio */
+        if (width == -1 || height == -1)
+            size_data->kind = SIZE_KIND_WH_MAX;
+        else
+            size_data->kind = SIZE_KIND_WH;
+        size_data->width = width;
+        size_data->height = height;
+    } else {
+        /* assume the user wants to zoom the image, but cap the maximum size */
+        size_data->kind = SIZE_KIND_ZOOM_MAX;
+        size_data->x_zoom = x_zoom;
+        size_data->y_zoom = y_zoom;
+        size_data->width = width;
+        size_data->height = height;
+    }
+
+    size_data->keep_aspect_ratio = keep_aspect_ratio;
+}
+
+/* Batch mode (--jobs/--files-from): each input file is converted independently
+ * to its own output file on a worker-pool thread.  The context is shared
+ * read-only between workers; only n_errors is written, atomically.
+ */
+typedef struct {
+    RsvgHandleFlags flags;
+    double dpi_x;
+    double dpi_y;
+    SizeMode size_data;
+    const char *format;
+    const char *output_dir;
+    const char *stylesheet_data;
+    gsize stylesheet_data_len;
+    const char *export_id;
+    gboolean have_background;
+    guint32 background_color;
+    gint n_errors;
+} BatchContext;
+
+static char *
+batch_output_filename (const char *input, const BatchContext *batch)
+{
+    char *base, *dot, *filename, *result;
+
+    base = g_path_get_basename (input);
+    dot = strrchr (base, '.');
+    if (dot != NULL && dot != base)
+        *dot = '\0';
+
+    filename = g_strdup_printf ("%s.%s", base, batch->format);
+
+    if (batch->output_dir != NULL) {
+        result = g_build_filename (batch->output_dir, filename, NULL);
+    } else {
+        char *dir = g_path_get_dirname (input);
+        result = g_build_filename (dir, filename, NULL);
+        g_free (dir);
+    }
+
+    g_free (filename);
+    g_free (base);
+    return result;
+}
+
+static void
+batch_convert_one (gpointer data, gpointer user_data)
+{
+    char *input = data;
+    BatchContext *batch = user_data;
+    GFile *file = NULL;
+    GInputStream *stream = NULL;
+    RsvgHandle *rsvg = NULL;
+    GError *error = NULL;
+    RsvgDimensionData dimensions;
+    SizeMode size_data;
+    char *export_lookup_id = NULL;
+    char *output_filename = NULL;
+    FILE *output_file = NULL;
+    cairo_surface_t *surface = NULL;
+    cairo_t *cr = NULL;
+    int scaled_width, scaled_height;
+
+    file = g_file_new_for_commandline_arg (input);
+    stream = (GInputStream *) g_file_read (file, NULL, &error);
+    if (stream == NULL)
+        goto fail;
+
+    rsvg = rsvg_handle_new_from_stream_sync (stream, file, batch->flags, NULL, &error);
+    if (rsvg == NULL)
+        goto fail;
+
+    if (batch->stylesheet_data != NULL
+        && !rsvg_handle_set_stylesheet (rsvg, batch->stylesheet_data,
+                                        batch->stylesheet_data_len, &error))
+        goto fail;
+
+    rsvg_handle_set_dpi_x_y (rsvg, batch->dpi_x, batch->dpi_y);
+
+    export_lookup_id = get_lookup_id_from_command_line (batch->export_id);
+    if (export_lookup_id != NULL && !rsvg_handle_has_sub (rsvg, export_lookup_id)) {
+        g_printerr (_("File %s does not have an object with id \"%s\"\n"),
+                    input, batch->export_id);
+        goto fail_no_error;
+    }
+
+    if (!rsvg_handle_get_dimensions_sub (rsvg, &dimensions, export_lookup_id)
+        || dimensions.width == 0 || dimensions.height == 0) {
+        g_printerr (_("The SVG %s has no dimensions\n"), input);
+        goto fail_no_error;
+    }
+
+    scaled_width = dimensions.width;
+    scaled_height = dimensions.height;
+    size_data = batch->size_data;
+    get_final_size (&scaled_width, &scaled_height, &size_data);
+
+    if (scaled_width > 32767 || scaled_height > 32767) {
+        g_printerr (_("The resulting image for %s would be larger than 32767 pixels "
+                      "on either dimension.\n"), input);
+        goto fail_no_error;
+    }
+
+    output_filename = batch_output_filename (input, batch);
+    if (strcmp (output_filename, input) == 0) {
+        g_printerr (_("Output file for %s would overwrite the input; skipping\n"), input);
+        goto fail_no_error;
+    }
+
+    output_file = fopen (output_filename, "wb");
+    if (!output_file) {
+        g_printerr (_("Error saving to file: %s\n"), output_filename);
+        goto fail_no_error;
+    }
+
+    if (g_str_equal (batch->format, "png"))
+        surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+                                              scaled_width, scaled_height);
+#ifdef CAIRO_HAS_PDF_SURFACE
+    else if (g_str_equal (batch->format, "pdf"))
+        surface = cairo_pdf_surface_create_for_stream (rsvg_cairo_write_func, output_file,
+                                                       scaled_width, scaled_height);
+#endif
+#ifdef CAIRO_HAS_PS_SURFACE
+    else if (g_str_equal (batch->format, "ps") || g_str_equal (batch->format, "eps")) {
+        surface = cairo_ps_surface_create_for_stream (rsvg_cairo_write_func, output_file,
+                                                      scaled_width, scaled_height);
+        if (g_str_equal (batch->format, "eps"))
+            cairo_ps_surface_set_eps (surface, TRUE);
+    }
+#endif
+#ifdef CAIRO_HAS_SVG_SURFACE
+    else if (g_str_equal (batch->format, "svg")) {
+        surface = cairo_svg_surface_create_for_stream (rsvg_cairo_write_func, output_file,
+                                                       scaled_width, scaled_height);
+        cairo_svg_surface_set_document_unit (surface, CAIRO_SVG_UNIT_PX);
+    }
+#endif
+    else {
+        g_printerr (_("Unknown output format.\n"));
+        goto fail_no_error;
+    }
+
+    cr = cairo_create (surface);
+    cairo_scale (cr,
+                 scaled_width / (double) dimensions.width,
+                 scaled_height / (double) dimensions.height);
+
+    if (batch->have_background) {
+        cairo_set_source_rgba (
+            cr,
+            ((batch->background_color >> 16) & 0xff) / 255.0,
+            ((batch->background_color >> 8) & 0xff) / 255.0,
+            ((batch->background_color >> 0) & 0xff) / 255.0,
+            ((batch->background_color >> 24) & 0xff) / 255.0);
+        cairo_rectangle (cr, 0, 0, dimensions.width, dimensions.height);
+        cairo_fill (cr);
+    }
+
+    if (export_lookup_id) {
+        RsvgPositionData pos;
+
+        if (!rsvg_handle_get_position_sub (rsvg, &pos, export_lookup_id)) {
+            g_printerr (_("File %s does not have an object with id \"%s\"\n"),
+                        input, batch->export_id);
+            goto fail_no_error;
+        }
+
+        /* Move the whole thing to 0, 0 so the object to export is at the origin */
+        cairo_translate (cr, -pos.x, -pos.y);
+    }
+
+    if (!rsvg_handle_render_cairo_sub (rsvg, cr, export_lookup_id)) {
+        g_printerr (_("Could not render file %s\n"), input);
+        goto fail_no_error;
+    }
+
+    if (g_str_equal (batch->format, "png"))
+        cairo_surface_write_to_png_stream (surface, rsvg_cairo_write_func, output_file);
+    else
+        cairo_show_page (cr);
+
+    goto out;
+
+fail:
+    g_printerr (_("Error converting %s:"), input);
+    display_error (error);
+    g_printerr ("\n");
+
+fail_no_error:
+    g_atomic_int_inc (&batch->n_errors);
+
+out:
+    if (cr)
+        cairo_destroy (cr);
+    if (surface)
+        cairo_surface_destroy (surface);
+    if (output_file)
+        fclose (output_file);
+    g_free (output_filename);
+    g_free (export_lookup_id);
+    g_clear_object (&rsvg);
+    g_clear_object (&stream);
+    g_clear_object (&file);
+    g_free (input);
+}
+
 int
 main (int argc, char **argv)
 {
@@ -227,6 +465,9 @@ main (int argc, char **argv)
     gboolean unlimited = FALSE;
     gboolean keep_image_data = FALSE;
     gboolean no_keep_image_data = FALSE;
+    int jobs = 1;
+    char *files_from = NULL;
+    gboolean batch_mode = FALSE;
     GError *error = NULL;
 
     gboolean success = TRUE;
@@ -287,6 +528,10 @@ main (int argc, char **argv)
         {"unlimited", 'u', 0, G_OPTION_ARG_NONE, &unlimited, N_("Allow huge SVG files"), NULL},
         {"keep-image-data", 0, 0, G_OPTION_ARG_NONE, &keep_image_data, N_("Keep image data"), NULL},
         {"no-keep-image-data", 0, 0, G_OPTION_ARG_NONE, &no_keep_image_data, N_("Don't keep image data"), NULL},
+        {"jobs", 'j', 0, G_OPTION_ARG_INT, &jobs,
+         N_("number of files to convert in parallel; enables batch mode [optional; defaults to 1]"), N_("<int>")},
+        {"files-from", 0, 0, G_OPTION_ARG_FILENAME, &files_from,
+         N_("read input filenames from a file, one per line, '-' for standard input; enables batch mode"), NULL},
         {"version", 'v', 0, G_OPTION_ARG_NONE, &bVersion, N_("show version information"), NULL},
         {G_OPTION_REMAINING, 0, 0, G_OPTION_ARG_FILENAME_ARRAY, &args, NULL, N_("[FILE...]")},
         {NULL}
@@ -319,27 +564,79 @@ main (int argc, char **argv)
         }
     }
 
-    if (output != NULL) {
-        output_file = fopen (output, "wb");
-        if (!output_file) {
-            g_printerr (_("Error saving to file: %s\n"), output);
-            g_free (output);
+    if (files_from != NULL) {
+        char *list_data = NULL;
+        char **lines;
+        GPtrArray *all_args;
+
+        if (g_str_equal (files_from, "-")) {
+            GString *contents = g_string_new (NULL);
+            char buf[4096];
+            size_t nread;
+
+            while ((nread = fread (buf, 1, sizeof (buf), stdin)) > 0)
+                g_string_append_len (contents, buf, nread);
+
+            list_data = g_string_free (contents, FALSE);
+        } else if (!g_file_get_contents (files_from, &list_data, NULL, &error)) {
+            g_printerr (_("Error reading file list: %s\n"), error->message);
             exit (1);
         }
 
-        g_free (output);
+        all_args = g_ptr_array_new ();
+
+        for (i = 0; args && args[i] != NULL; i++)
+            g_ptr_array_add (all_args, g_strdup (args[i]));
+
+        lines = g_strsplit (list_data, "\n", -1);
+        for (i = 0; lines[i] != NULL; i++) {
+            g_strchomp (lines[i]);
+            if (*lines[i] != '\0')
+                g_ptr_array_add (all_args, g_strdup (lines[i]));
+        }
+        g_strfreev (lines);
+        g_free (list_data);
+
+        g_ptr_array_add (all_args, NULL);
+        g_strfreev (args);
+        args = (char **) g_ptr_array_free (all_args, FALSE);
     }
+
+    batch_mode = jobs != 1 || files_from != NULL;
+
+    if (!batch_mode) {
+        if (output != NULL) {
+            output_file = fopen (output, "wb");
+            if (!output_file) {
+                g_printerr (_("Error saving to file: %s\n"), output);
+                g_free (output);
+                exit (1);
+            }
+
+            g_free (output);
+        }
 #ifdef G_OS_WIN32
-    else {
-        setmode (fileno (stdout), O_BINARY);
+        else {
+            setmode (fileno (stdout), O_BINARY);
+        }
+#endif
     }
-#endif   
 
     if (args)
         while (args[n_args] != NULL)
             n_args++;
 
-    if (n_args == 0) {
+    if (batch_mode) {
+        if (jobs < 1) {
+            g_printerr (_("Invalid number of jobs: %d\n"), jobs);
+            exit (1);
+        }
+
+        if (n_args == 0) {
+            g_printerr (_("No input files given for batch conversion.\n"));
+            exit (1);
+        }
+    } else if (n_args == 0) {
         const gchar * const stdin_args[] = { "stdin", NULL };
         n_args = 1;
         using_stdin = TRUE;
@@ -372,6 +669,69 @@ main (int argc, char **argv)
     if (keep_image_data)
         flags |= RSVG_HANDLE_FLAG_KEEP_IMAGE_DATA;
 
+    if (batch_mode) {
+        BatchContext batch;
+        GThreadPool *pool;
+
+        memset (&batch, 0, sizeof (batch));
+        batch.flags = flags;
+        batch.dpi_x = dpi_x;
+        batch.dpi_y = dpi_y;
+        build_size_mode (&batch.size_data, width, height, x_zoom, y_zoom, keep_aspect_ratio);
+        batch.format = format ? format : "png";
+        batch.stylesheet_data = stylesheet_data;
+        batch.stylesheet_data_len = stylesheet_data_len;
+        batch.export_id = export_id;
+
+        if (!(g_str_equal (batch.format, "png")
+              || g_str_equal (batch.format, "pdf")
+              || g_str_equal (batch.format, "ps")
+              || g_str_equal (batch.format, "eps")
+              || g_str_equal (batch.format, "svg"))) {
+            g_printerr (_("Batch conversion is only supported for png, pdf, ps, eps and svg output.\n"));
+            exit (1);
+        }
+
+        if (background_color_str && g_ascii_strcasecmp (background_color_str, "none") != 0) {
+            RsvgCssColorSpec spec;
+
+            spec = rsvg_css_parse_color_ (background_color_str);
+            if (spec.kind != RSVG_CSS_COLOR_SPEC_ARGB) {
+                g_printerr (_("Invalid color specification.\n"));
+                exit (1);
+            }
+
+            batch.have_background = TRUE;
+            batch.background_color = spec.argb;
+        }
+
+        if (output != NULL) {
+            if (g_mkdir_with_parents (output, 0755) != 0) {
+                g_printerr (_("Error creating output directory: %s\n"), output);
+                exit (1);
+            }
+
+            batch.output_dir = output;
+        }
+
+        pool = g_thread_pool_new (batch_convert_one, &batch, jobs, FALSE, &error);
+        if (pool == NULL) {
+            display_error (error);
+            exit (1);
+        }
+
+        for (i = 0; i < n_args; i++)
+            g_thread_pool_push (pool, g_strdup (args[i]), NULL);
+
+        /* Blocks until every queued conversion has finished */
+        g_thread_pool_free (pool, FALSE, TRUE);
+
+        g_strfreev (args);
+        g_free (output);
+
+        return g_atomic_int_get (&batch.n_errors) > 0 ? 1 : 0;
+    }
+
     for (i = 0; i < n_args && success; i++) {
         GFile *file;
         GInputStream *stream;
@@ -446,34 +806,7 @@ main (int argc, char **argv)
             unscaled_width = dimensions.width;
             unscaled_height = dimensions.height;
 
-            /* if both are unspecified, assume user wants to zoom the image in at least 1 dimension */
-            if (width == -1 && height == -1) {
-                size_data.kind = SIZE_KIND_ZOOM;
-                size_data.x_zoom = x_zoom;
-                size_data.y_zoom = y_zoom;
-                size_data.keep_aspect_ratio = keep_aspect_ratio;
-            } else if (x_zoom == 1.0 && y_zoom == 1.0) {
-                /* if one parameter is unspecified, assume user wants to keep the aspect ratio */
-                if (width == -1 || height == -1) {
-                    size_data.kind = SIZE_KIND_WH_MAX;
-                    size_data.width = width;
-                    size_data.height = height;
-                    size_data.keep_aspect_ratio = keep_aspect_ratio;
-                } else {
-                    size_data.kind = SIZE_KIND_WH;
-                    size_data.width = width;
-                    size_data.height = height;
-                    size_data.keep_aspect_ratio = keep_aspect_ratio;
-                }
-            } else {
-                /* assume the user wants to zoom the image, but cap the maximum size */
-                size_data.kind = SIZE_KIND_ZOOM_MAX;
-                size_data.x_zoom = x_zoom;
-                size_data.y_zoom = y_zoom;
-                size_data.width = width;
-                size_data.height = height;
-                size_data.keep_aspect_ratio = keep_aspect_ratio;
-            }
+            build_size_mode (&size_data, width, height, x_zoom, y_zoom, keep_aspect_ratio);
 
             scaled_width = dimensions.width;
             scaled_height = dimensions.height;
@@ -40,6 +40,31 @@ fn bench_composite(c: &mut Criterion) {
             );
         })
     });
+
+    c.bench_function("composite arithmetic full surface", |b| {
+        let input_surface =
+            SharedImageSurface::empty(SURFACE_SIDE, SURFACE_SIDE, SurfaceType::SRgb).unwrap();
+        let input_2_surface =
+            SharedImageSurface::empty(SURFACE_SIDE, SURFACE_SIDE, SurfaceType::SRgb).unwrap();
+
+        let mut output_surface =
+            ExclusiveImageSurface::new(SURFACE_SIDE, SURFACE_SIDE, SurfaceType::SRgb).unwrap();
+
+        let bounds = black_box(IRect::from_size(SURFACE_SIDE, SURFACE_SIDE));
+
+        b.iter(|| {
+            composite_arithmetic(
+                &input_surface,
+                &input_2_surface,
+                &mut output_surface,
+                bounds,
+                0.5,
+                0.5,
+                0.5,
+                0.5,
+            );
+        })
+    });
 }
 
 criterion_group!(benches, bench_composite);
@@ -0,0 +1,30 @@
+#[macro_use]
+extern crate criterion;
+use criterion::{black_box, Criterion};
+
+use rsvg_internals::css::{Origin, Stylesheet};
+
+// A stylesheet with a mix of the selector shapes that show up in real
+// documents: type, class, id, descendant and child combinators, and
+// attribute selectors.
+static STYLESHEET: &str = "
+    rect { fill: blue; stroke: green; stroke-width: 2; }
+    circle, ellipse { fill: #ff0000; opacity: 0.5; }
+    .shaded { fill-opacity: 0.25; stroke-dasharray: 2 2; }
+    .outline { fill: none; stroke: black; }
+    #main { transform: translate(10, 10); }
+    #legend text { font-family: sans-serif; font-size: 12px; }
+    g.layer > path { stroke-linejoin: round; stroke-linecap: round; }
+    g g g rect { fill: yellow; }
+    path[marker-end] { stroke: purple; }
+    *.everything { visibility: hidden; }
+";
+
+fn bench_stylesheet_parse(c: &mut Criterion) {
+    c.bench_function("stylesheet from_data", |b| {
+        b.iter(|| Stylesheet::from_data(black_box(STYLESHEET), None, Origin::Author).unwrap())
+    });
+}
+
+criterion_group!(benches, bench_stylesheet_parse);
+criterion_main!(benches);
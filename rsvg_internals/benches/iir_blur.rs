@@ -0,0 +1,49 @@
+#[macro_use]
+extern crate criterion;
+use criterion::Criterion;
+
+use rsvg_internals::rect::IRect;
+use rsvg_internals::surface_utils::shared_surface::{
+    AlphaOnly, Horizontal, NotAlphaOnly, SharedImageSurface, SurfaceType, Vertical,
+};
+
+const SURFACE_SIDE: i32 = 512;
+const BOUNDS: IRect = IRect {
+    x0: 64,
+    y0: 64,
+    x1: 64 + 64,
+    y1: 64 + 64,
+};
+
+fn bench_iir_blur(c: &mut Criterion) {
+    c.bench_function_over_inputs(
+        "iir_blur 40",
+        |b, &(vertical, alpha_only)| {
+            let surface_type = if alpha_only {
+                SurfaceType::AlphaOnly
+            } else {
+                SurfaceType::SRgb
+            };
+            let input_surface =
+                SharedImageSurface::empty(SURFACE_SIDE, SURFACE_SIDE, surface_type).unwrap();
+
+            let mut output_surface =
+                cairo::ImageSurface::create(cairo::Format::ARgb32, SURFACE_SIDE, SURFACE_SIDE)
+                    .unwrap();
+            const STD_DEVIATION: f64 = 40.0;
+
+            let f = match (vertical, alpha_only) {
+                (true, true) => SharedImageSurface::iir_blur_loop::<Vertical, AlphaOnly>,
+                (true, false) => SharedImageSurface::iir_blur_loop::<Vertical, NotAlphaOnly>,
+                (false, true) => SharedImageSurface::iir_blur_loop::<Horizontal, AlphaOnly>,
+                (false, false) => SharedImageSurface::iir_blur_loop::<Horizontal, NotAlphaOnly>,
+            };
+
+            b.iter(|| f(&input_surface, &mut output_surface, BOUNDS, STD_DEVIATION))
+        },
+        vec![(false, false), (false, true), (true, false), (true, true)],
+    );
+}
+
+criterion_group!(benches, bench_iir_blur);
+criterion_main!(benches);
@@ -0,0 +1,41 @@
+#[macro_use]
+extern crate criterion;
+use criterion::{black_box, Criterion};
+
+use rsvg_internals::path_builder::PathBuilder;
+use rsvg_internals::path_parser::parse_path_into_builder;
+
+fn path_for(name: &str) -> &'static str {
+    match name {
+        "lines" => "M 10 20 L 30 40 L 50 60 L 70 80 L 90 100 l 10 10 l -10 10 l 10 10 Z",
+        "curves" => {
+            "M 10 10 C 20 20, 40 20, 50 10 S 70 0, 80 10 Q 90 20, 100 10 T 120 10 \
+             c 10 10, 30 10, 40 0 s 20 -10, 30 0 q 10 10, 20 0 t 20 0 z"
+        }
+        "arcs" => "M 300 200 A 150 150 0 1 0 150 50 a 75 75 0 0 1 75 75 A 10 10 30 1 1 280 180 z",
+        "relative" => {
+            "m 0 0 h 10 v 10 h -10 z m 20 0 h 10 v 10 h -10 z m 40 0 h 10 v 10 h -10 z \
+             m 60 0 h 10 v 10 h -10 z m 80 0 h 10 v 10 h -10 z"
+        }
+        _ => unreachable!(),
+    }
+}
+
+fn bench_path_parser(c: &mut Criterion) {
+    c.bench_function_over_inputs(
+        "parse_path_into_builder",
+        |b, name| {
+            let path_str = path_for(name);
+
+            b.iter(|| {
+                let mut builder = PathBuilder::new();
+                parse_path_into_builder(black_box(path_str), &mut builder).unwrap();
+                builder
+            })
+        },
+        vec!["lines", "curves", "arcs", "relative"],
+    );
+}
+
+criterion_group!(benches, bench_path_parser);
+criterion_main!(benches);
@@ -0,0 +1,104 @@
+#[macro_use]
+extern crate criterion;
+use criterion::Criterion;
+
+use gio::prelude::*;
+
+use rsvg_internals::{Dpi, Handle, LoadOptions};
+
+// A small but representative document: nested groups, a gradient, paths,
+// basic shapes, opacity, and an internal stylesheet so the CSS cascade
+// runs as part of loading and rendering.
+static DOCUMENT: &str = r##"<?xml version="1.0" encoding="UTF-8"?>
+<svg xmlns="http://www.w3.org/2000/svg" width="400" height="400" viewBox="0 0 400 400">
+  <style>
+    rect { stroke: black; stroke-width: 2; }
+    .shaded { fill-opacity: 0.5; }
+    #star { fill: goldenrod; }
+    g.layer path { stroke-linejoin: round; }
+  </style>
+  <defs>
+    <linearGradient id="grad" x1="0" y1="0" x2="1" y2="1">
+      <stop offset="0" stop-color="#3366cc"/>
+      <stop offset="0.5" stop-color="#cc3366"/>
+      <stop offset="1" stop-color="#66cc33"/>
+    </linearGradient>
+  </defs>
+  <rect x="0" y="0" width="400" height="400" fill="url(#grad)"/>
+  <g class="layer" opacity="0.8">
+    <path id="star" d="M 200 50 L 230 150 L 340 150 L 250 210 L 280 320
+                       L 200 255 L 120 320 L 150 210 L 60 150 L 170 150 Z"/>
+    <path d="M 50 350 C 100 300, 150 400, 200 350 S 300 300, 350 350"
+          fill="none" stroke="#333333" stroke-width="4"/>
+  </g>
+  <g class="shaded">
+    <circle cx="100" cy="100" r="40" fill="teal"/>
+    <ellipse cx="300" cy="100" rx="50" ry="30" fill="maroon"/>
+    <rect x="250" y="250" width="100" height="100" rx="15" fill="olive"/>
+  </g>
+</svg>"##;
+
+fn load_handle() -> Handle {
+    let stream = gio::MemoryInputStream::new_from_bytes(&glib::Bytes::from_static(
+        DOCUMENT.as_bytes(),
+    ));
+
+    Handle::from_stream(&LoadOptions::new(None), &stream.upcast(), None).unwrap()
+}
+
+fn bench_render_document(c: &mut Criterion) {
+    c.bench_function("load document", |b| b.iter(|| load_handle()));
+
+    c.bench_function("render document", |b| {
+        let handle = load_handle();
+        let surface = cairo::ImageSurface::create(cairo::Format::ARgb32, 400, 400).unwrap();
+        let cr = cairo::Context::new(&surface);
+        let viewport = cairo::Rectangle {
+            x: 0.0,
+            y: 0.0,
+            width: 400.0,
+            height: 400.0,
+        };
+
+        // Alternate between two viewports so every iteration renders the
+        // scene instead of replaying the retained display list.
+        let other = cairo::Rectangle {
+            width: 399.0,
+            ..viewport
+        };
+        let mut flip = false;
+
+        b.iter(|| {
+            flip = !flip;
+            handle
+                .render_document(
+                    &cr,
+                    if flip { &viewport } else { &other },
+                    Dpi::new(96.0, 96.0),
+                    false,
+                )
+                .unwrap()
+        })
+    });
+
+    c.bench_function("render document replay", |b| {
+        let handle = load_handle();
+        let surface = cairo::ImageSurface::create(cairo::Format::ARgb32, 400, 400).unwrap();
+        let cr = cairo::Context::new(&surface);
+        let viewport = cairo::Rectangle {
+            x: 0.0,
+            y: 0.0,
+            width: 400.0,
+            height: 400.0,
+        };
+
+        b.iter(|| {
+            handle
+                .render_document(&cr, &viewport, Dpi::new(96.0, 96.0), false)
+                .unwrap()
+        })
+    });
+}
+
+criterion_group!(benches, bench_render_document);
+criterion_main!(benches);
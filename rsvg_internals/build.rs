@@ -113,6 +113,38 @@ fn print_table<W: Write>(w: &mut W, name: &str, table: &[u8]) {
     writeln!(w, "];").unwrap();
 }
 
+/// Computes the alpha unpremultiplication table.
+///
+/// `UNPREMULTIPLY[a][x]` is the result of unpremultiplying the component value `x` by the alpha
+/// value `a`, rounded to the nearest integer and clamped to `u8`, matching
+/// `(f64::from(x) / (f64::from(a) / 255.0) + 0.5) as u8`. The row for `a == 0` is unused (fully
+/// transparent pixels are skipped) and filled with zeros.
+fn compute_unpremultiply_table() -> Vec<[u8; 256]> {
+    let mut table = vec![[0; 256]; 256];
+
+    for a in 1..=255usize {
+        for x in 0..=255usize {
+            table[a][x] = ((x * 255 + a / 2) / a).min(255) as u8;
+        }
+    }
+
+    table
+}
+
+fn print_unpremultiply_table<W: Write>(w: &mut W, table: &[[u8; 256]]) {
+    writeln!(w, "const UNPREMULTIPLY: [[u8; 256]; {}] = [", table.len()).unwrap();
+
+    for row in table {
+        write!(w, "    [").unwrap();
+        for x in row.iter() {
+            write!(w, "{},", x).unwrap();
+        }
+        writeln!(w, "],").unwrap();
+    }
+
+    writeln!(w, "];").unwrap();
+}
+
 fn generate_srgb_tables() {
     let linearize_table = compute_table(linearize);
     let unlinearize_table = compute_table(unlinearize);
@@ -122,4 +154,5 @@ fn generate_srgb_tables() {
 
     print_table(&mut file, "LINEARIZE", &linearize_table);
     print_table(&mut file, "UNLINEARIZE", &unlinearize_table);
+    print_unpremultiply_table(&mut file, &compute_unpremultiply_table());
 }
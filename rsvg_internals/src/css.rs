@@ -79,11 +79,16 @@ use cssparser::{
     RuleListParser, SourceLocation, ToCss, _cssparser_internal_to_lowercase,
 };
 use markup5ever::{namespace_url, ns, LocalName, Namespace, Prefix, QualName};
+use precomputed_hash::PrecomputedHash;
 use selectors::attr::{AttrSelectorOperation, CaseSensitivity, NamespaceConstraint};
+use selectors::bloom::BloomFilter;
 use selectors::matching::{ElementSelectorFlags, MatchingContext, MatchingMode, QuirksMode};
+use selectors::parser::AncestorHashes;
 use selectors::{OpaqueElement, SelectorImpl, SelectorList};
 use std::cmp::Ordering;
+use std::collections::HashMap;
 use std::fmt;
+use std::rc::Rc;
 use std::str;
 use url::Url;
 
@@ -91,7 +96,7 @@ use crate::allowed_url::AllowedUrl;
 use crate::error::*;
 use crate::io::{self, BinaryData};
 use crate::node::{Node, NodeBorrow, NodeCascade};
-use crate::properties::{parse_property, ComputedValues, ParsedProperty};
+use crate::properties::{parse_property, ComputedValues, ParsedProperty, StyleSharingCache};
 
 /// A parsed CSS declaration
 ///
@@ -574,6 +579,77 @@ pub enum Origin {
 pub struct Stylesheet {
     origin: Origin,
     qualified_rules: Vec<QualifiedRule>,
+    index: SelectorIndex,
+}
+
+/// Reference to one selector of one qualified rule, plus its precomputed ancestor
+/// hashes for bloom-filter rejection.
+struct IndexedSelector {
+    rule: usize,
+    selector: usize,
+    hashes: AncestorHashes,
+}
+
+/// Index of a stylesheet's selectors, bucketed by the rightmost compound.
+///
+/// Testing every selector against every element makes the cascade O(rules × nodes),
+/// which blows up on documents exported from design tools.  Instead, each selector is
+/// placed in exactly one bucket according to the most selective part of its rightmost
+/// compound (id, then class, then type), like browser style engines do.  During
+/// matching, an element only tests the selectors from the buckets it can possibly
+/// match: the bucket for its own id, one per class it carries, the one for its element
+/// name, and the catch-all bucket.
+#[derive(Default)]
+struct SelectorIndex {
+    by_id: HashMap<LocalName, Vec<IndexedSelector>>,
+    by_class: HashMap<LocalName, Vec<IndexedSelector>>,
+    by_local_name: HashMap<LocalName, Vec<IndexedSelector>>,
+    other: Vec<IndexedSelector>,
+}
+
+impl SelectorIndex {
+    /// Adds all the selectors of the rule with index `rule_idx` to the index.
+    fn add_rule(&mut self, rule_idx: usize, rule: &QualifiedRule) {
+        for (selector_idx, selector) in rule.selectors.0.iter().enumerate() {
+            let indexed = IndexedSelector {
+                rule: rule_idx,
+                selector: selector_idx,
+                hashes: AncestorHashes::new(selector, QuirksMode::NoQuirks),
+            };
+
+            let mut class = None;
+            let mut local_name = None;
+            let mut id = None;
+
+            // iter() yields the components of the rightmost compound selector.
+            for component in selector.iter() {
+                use selectors::parser::Component;
+
+                match *component {
+                    Component::ID(ref name) => id = Some(name.clone()),
+                    Component::Class(ref name) => class = Some(name.clone()),
+                    Component::LocalName(ref name) => local_name = Some(name.name.clone()),
+                    _ => (),
+                }
+            }
+
+            if let Some(id) = id {
+                self.by_id.entry(id).or_insert_with(Vec::new).push(indexed);
+            } else if let Some(class) = class {
+                self.by_class
+                    .entry(class)
+                    .or_insert_with(Vec::new)
+                    .push(indexed);
+            } else if let Some(local_name) = local_name {
+                self.by_local_name
+                    .entry(local_name)
+                    .or_insert_with(Vec::new)
+                    .push(indexed);
+            } else {
+                self.other.push(indexed);
+            }
+        }
+    }
 }
 
 /// A match during the selector matching process
@@ -619,6 +695,7 @@ impl Stylesheet {
         Stylesheet {
             origin,
             qualified_rules: Vec::new(),
+            index: SelectorIndex::default(),
         }
     }
 
@@ -663,7 +740,10 @@ impl Stylesheet {
                     // ignore invalid imports
                     let _ = self.load(&url, base_url);
                 }
-                Rule::QualifiedRule(qr) => self.qualified_rules.push(qr),
+                Rule::QualifiedRule(qr) => {
+                    self.index.add_rule(self.qualified_rules.len(), &qr);
+                    self.qualified_rules.push(qr);
+                }
             });
 
         Ok(())
@@ -706,26 +786,82 @@ impl Stylesheet {
         match_ctx: &mut MatchingContext<Selector>,
         acc: &mut Vec<Match<'a>>,
     ) {
-        for rule in &self.qualified_rules {
-            for selector in &rule.selectors.0 {
-                // This magic call is stolen from selectors::matching::matches_selector_list()
-                if selectors::matching::matches_selector(
-                    selector,
-                    0,
-                    None,
-                    &RsvgElement(node.clone()),
-                    match_ctx,
-                    &mut |_, _| {},
-                ) {
-                    for decl in rule.declarations.iter() {
-                        acc.push(Match {
-                            declaration: decl,
-                            specificity: selector.specificity(),
-                            origin: self.origin,
-                        });
+        // Gather the selectors from the index buckets this element can possibly match.
+        let mut candidates: Vec<&IndexedSelector> = Vec::new();
+
+        {
+            let element = node.borrow_element();
+
+            if let Some(id) = element.get_id() {
+                if let Some(v) = self.index.by_id.get(&LocalName::from(id)) {
+                    candidates.extend(v.iter());
+                }
+            }
+
+            if let Some(classes) = element.get_class() {
+                for class in classes.split_whitespace() {
+                    if let Some(v) = self.index.by_class.get(&LocalName::from(class)) {
+                        candidates.extend(v.iter());
                     }
                 }
             }
+
+            if let Some(v) = self.index.by_local_name.get(&element.element_name().local) {
+                candidates.extend(v.iter());
+            }
+
+            candidates.extend(self.index.other.iter());
+        }
+
+        // Process the candidates in document order of their rules, so that rules of
+        // equal origin and specificity keep applying in the order they were written
+        // (the final sort of Match is stable).
+        candidates.sort_unstable_by_key(|indexed| (indexed.rule, indexed.selector));
+
+        for indexed in candidates {
+            let rule = &self.qualified_rules[indexed.rule];
+            let selector = &rule.selectors.0[indexed.selector];
+
+            // This magic call is stolen from selectors::matching::matches_selector_list()
+            if selectors::matching::matches_selector(
+                selector,
+                0,
+                Some(&indexed.hashes),
+                &RsvgElement(node.clone()),
+                match_ctx,
+                &mut |_, _| {},
+            ) {
+                for decl in rule.declarations.iter() {
+                    acc.push(Match {
+                        declaration: decl,
+                        specificity: selector.specificity(),
+                        origin: self.origin,
+                    });
+                }
+            }
+        }
+    }
+}
+
+/// Calls `f` with the bloom filter hash of each ancestor-relevant feature of an element:
+/// its local name, namespace, id, and classes.
+///
+/// These are the same features that `AncestorHashes` extracts from a selector, so the
+/// hashes have to be computed with the same `PrecomputedHash` implementations.
+fn each_element_hash<F: FnMut(u32)>(node: &Node, mut f: F) {
+    let element = node.borrow_element();
+
+    let name = element.element_name();
+    f(name.local.precomputed_hash());
+    f(name.ns.precomputed_hash());
+
+    if let Some(id) = element.get_id() {
+        f(LocalName::from(id).precomputed_hash());
+    }
+
+    if let Some(classes) = element.get_class() {
+        for class in classes.split_whitespace() {
+            f(LocalName::from(class).precomputed_hash());
         }
     }
 }
@@ -737,38 +873,74 @@ pub fn cascade(
     author_stylesheets: &[Stylesheet],
     user_stylesheets: &[Stylesheet],
 ) {
-    for mut node in root.descendants().filter(|n| n.is_element()) {
-        let mut matches = Vec::new();
-
-        let mut match_ctx = MatchingContext::new(
-            MatchingMode::Normal,
-            // FIXME: how the fuck does one set up a bloom filter here?
-            None,
-            // n_index_cache,
-            None,
-            QuirksMode::NoQuirks,
-        );
+    // The bloom filter accumulates the features of the current element's ancestor
+    // chain; matches_selector() uses it together with each selector's AncestorHashes
+    // to cheaply reject selectors whose ancestor requirements cannot be met.
+    //
+    // The traversal uses an explicit stack (rather than recursion) so that deep
+    // documents cannot overflow the machine stack, with an Ascend marker to remove an
+    // element's hashes once its subtree is done.
+    let mut bloom = BloomFilter::new();
+
+    enum Walk {
+        Descend(Node),
+        Ascend(Node),
+    }
 
-        for s in ua_stylesheets
-            .iter()
-            .chain(author_stylesheets)
-            .chain(user_stylesheets)
-        {
-            s.get_matches(&node, &mut match_ctx, &mut matches);
-        }
+    let mut walk_stack = vec![Walk::Descend(root.clone())];
+
+    while let Some(walk) = walk_stack.pop() {
+        let mut node = match walk {
+            Walk::Ascend(node) => {
+                each_element_hash(&node, |hash| bloom.remove_hash(hash));
+                continue;
+            }
 
-        matches.as_mut_slice().sort();
+            Walk::Descend(node) => node,
+        };
+
+        if node.is_element() {
+            let mut matches = Vec::new();
+
+            let mut match_ctx = MatchingContext::new(
+                MatchingMode::Normal,
+                Some(&bloom),
+                // n_index_cache,
+                None,
+                QuirksMode::NoQuirks,
+            );
+
+            for s in ua_stylesheets
+                .iter()
+                .chain(author_stylesheets)
+                .chain(user_stylesheets)
+            {
+                s.get_matches(&node, &mut match_ctx, &mut matches);
+            }
+
+            matches.as_mut_slice().sort();
+
+            for m in matches {
+                node.borrow_element_mut()
+                    .apply_style_declaration(m.declaration, m.origin);
+            }
+
+            node.borrow_element_mut().set_style_attribute();
 
-        for m in matches {
-            node.borrow_element_mut()
-                .apply_style_declaration(m.declaration, m.origin);
+            each_element_hash(&node, |hash| bloom.insert_hash(hash));
+            walk_stack.push(Walk::Ascend(node.clone()));
         }
 
-        node.borrow_element_mut().set_style_attribute();
+        // Push the children in reverse so they get popped in document order.
+        let children: Vec<_> = node.children().collect();
+        for child in children.into_iter().rev() {
+            walk_stack.push(Walk::Descend(child));
+        }
     }
 
-    let values = ComputedValues::default();
-    root.cascade(&values);
+    let values = Rc::new(ComputedValues::default());
+    let mut style_sharing_cache = StyleSharingCache::new();
+    root.cascade(&values, &mut style_sharing_cache);
 }
 
 #[cfg(test)]
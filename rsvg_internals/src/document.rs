@@ -18,7 +18,10 @@ use crate::limits;
 use crate::node::{Node, NodeBorrow, NodeData};
 use crate::property_bag::PropertyBag;
 use crate::surface_utils::shared_surface::SharedImageSurface;
-use crate::xml::xml_load_from_possibly_compressed_stream;
+use crate::xml::{
+    xml_load_from_cache, xml_load_from_possibly_compressed_stream,
+    xml_load_from_possibly_compressed_stream_recording, XmlPushParser,
+};
 
 static UA_STYLESHEETS: Lazy<Vec<Stylesheet>> = Lazy::new(|| {
     vec![Stylesheet::from_data(include_str!("ua.css"), None, Origin::UserAgent).unwrap()]
@@ -63,6 +66,47 @@ impl Document {
         )
     }
 
+    /// Like `load_from_stream`, but also returns the document's serialized pre-parsed
+    /// event cache, suitable for `load_from_cache`.
+    pub fn load_from_stream_and_record(
+        load_options: &LoadOptions,
+        stream: &gio::InputStream,
+        cancellable: Option<&gio::Cancellable>,
+    ) -> Result<(Document, Vec<u8>), LoadingError> {
+        xml_load_from_possibly_compressed_stream_recording(
+            DocumentBuilder::new(load_options),
+            load_options.unlimited_size,
+            stream,
+            cancellable,
+        )
+    }
+
+    /// Loads a `Document` from a pre-parsed event cache, skipping the XML parser.
+    ///
+    /// Fails if `data` is not a cache of the current format version; callers should
+    /// then fall back to parsing the original XML.
+    pub fn load_from_cache(
+        load_options: &LoadOptions,
+        data: &[u8],
+    ) -> Result<Document, LoadingError> {
+        xml_load_from_cache(
+            DocumentBuilder::new(load_options),
+            load_options.unlimited_size,
+            data,
+        )
+    }
+
+    /// Starts loading a `Document` incrementally from chunks of bytes.
+    ///
+    /// The returned parser consumes chunks as they arrive and yields the
+    /// finished `Document` when closed; see `XmlPushParser`.
+    pub fn load_incrementally(load_options: &LoadOptions) -> Result<XmlPushParser, LoadingError> {
+        XmlPushParser::new(
+            DocumentBuilder::new(load_options),
+            load_options.unlimited_size,
+        )
+    }
+
     /// Gets the root node.  This is guaranteed to be an `<svg>` element.
     pub fn root(&self) -> Node {
         self.tree.clone()
@@ -233,6 +277,30 @@ fn load_image(
     Ok(surface)
 }
 
+impl Drop for Document {
+    fn drop(&mut self) {
+        // Drop the tree iteratively, one node at a time.
+        //
+        // If we just let the tree's root go out of scope, rctree first collects
+        // every descendant into one temporary vector so that the nested drops don't
+        // overflow the stack, and only then unlinks them.  For 100k-node documents
+        // that means a huge allocation and two full traversals right inside
+        // rsvg_handle_free().  Detaching children as we walk lets each node be
+        // freed as soon as it is popped, in a single pass.
+        let mut stack = vec![self.tree.clone()];
+
+        while let Some(node) = stack.pop() {
+            let mut next = node.first_child();
+
+            while let Some(mut child) = next {
+                next = child.next_sibling();
+                child.detach();
+                stack.push(child);
+            }
+        }
+    }
+}
+
 pub struct AcquiredNode {
     stack: Option<Rc<RefCell<NodeStack>>>,
     node: Node,
@@ -282,6 +350,11 @@ impl<'i> AcquiredNodes<'i> {
         self.document.lookup_image(href)
     }
 
+    /// Returns how many element references have been resolved so far.
+    pub fn num_elements_acquired(&self) -> usize {
+        self.num_elements_acquired
+    }
+
     /// Acquires a node.
     /// Nodes acquired by this function must be released in reverse acquiring order.
     pub fn acquire(&mut self, fragment: &Fragment) -> Result<AcquiredNode, AcquireError> {
@@ -1,6 +1,6 @@
 //! Resolution for rendering (dots per inch = DPI).
 
-#[derive(Debug, Copy, Clone)]
+#[derive(Debug, Copy, Clone, PartialEq)]
 pub struct Dpi {
     pub x: f64,
     pub y: f64,
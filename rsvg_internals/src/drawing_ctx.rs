@@ -81,6 +81,39 @@ pub enum ClipMode {
     ClipToVbox,
 }
 
+/// Counters accumulated while rendering a document.
+///
+/// `DrawingCtx` tallies these during a rendering pass; `Handle` keeps the
+/// totals of the last pass so they can be reported through the C API.
+#[derive(Debug, Default, Clone, Copy, PartialEq)]
+pub struct RenderStats {
+    /// Number of nodes that were actually drawn (visible and on the render path).
+    pub nodes_rendered: usize,
+
+    /// Number of element references resolved, i.e. what
+    /// `limits::MAX_REFERENCED_ELEMENTS` guards against.
+    pub elements_referenced: usize,
+
+    /// Number of filter primitives executed.
+    pub filter_primitives: usize,
+
+    /// Bytes allocated for temporary surfaces (masks, opacity groups, filter
+    /// intermediates), assuming 4 bytes per pixel.
+    pub temporary_surface_bytes: usize,
+
+    /// Seconds spent executing filter primitives.
+    pub filter_elapsed: f64,
+
+    /// Seconds spent in the whole rendering pass, filters included.
+    pub render_elapsed: f64,
+}
+
+impl RenderStats {
+    pub fn count_temporary_surface(&mut self, width: i32, height: i32) {
+        self.temporary_surface_bytes += width as usize * height as usize * 4;
+    }
+}
+
 pub struct DrawingCtx {
     initial_transform: Transform,
 
@@ -96,6 +129,8 @@ pub struct DrawingCtx {
 
     measuring: bool,
     testing: bool,
+
+    stats: RefCell<RenderStats>,
 }
 
 impl DrawingCtx {
@@ -146,6 +181,7 @@ impl DrawingCtx {
             drawsub_stack: Vec::new(),
             measuring,
             testing,
+            stats: RefCell::new(RenderStats::default()),
         };
 
         if let Some(node) = node {
@@ -169,6 +205,14 @@ impl DrawingCtx {
         self.testing
     }
 
+    pub fn stats(&self) -> RenderStats {
+        *self.stats.borrow()
+    }
+
+    pub fn stats_mut(&self) -> std::cell::RefMut<'_, RenderStats> {
+        self.stats.borrow_mut()
+    }
+
     pub fn get_cairo_context(&self) -> cairo::Context {
         self.cr.clone()
     }
@@ -218,6 +262,8 @@ impl DrawingCtx {
     ) -> Result<cairo::ImageSurface, RenderingError> {
         let (w, h) = self.size_for_temporary_surface();
 
+        self.stats.borrow_mut().count_temporary_surface(w, h);
+
         Ok(cairo::ImageSurface::create(cairo::Format::ARgb32, w, h)?)
     }
 
@@ -227,6 +273,8 @@ impl DrawingCtx {
     ) -> Result<cairo::Surface, RenderingError> {
         let (w, h) = self.size_for_temporary_surface();
 
+        self.stats.borrow_mut().count_temporary_surface(w, h);
+
         Ok(cairo::Surface::create_similar(
             surface,
             cairo::Content::ColorAlpha,
@@ -1073,6 +1121,8 @@ impl DrawingCtx {
         width: i32,
         height: i32,
     ) -> Result<SharedImageSurface, RenderingError> {
+        self.stats.borrow_mut().count_temporary_surface(width, height);
+
         let surface = cairo::ImageSurface::create(cairo::Format::ARgb32, width, height)?;
 
         let save_cr = self.cr.clone();
@@ -1112,6 +1162,7 @@ impl DrawingCtx {
 
         let values = cascaded.get();
         let res = if draw && values.is_visible() {
+            self.stats.borrow_mut().nodes_rendered += 1;
             node.draw(acquired_nodes, cascaded, self, clipping)
         } else {
             Ok(self.empty_bbox())
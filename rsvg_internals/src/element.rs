@@ -7,6 +7,7 @@ use once_cell::sync::Lazy;
 use std::collections::{HashMap, HashSet};
 use std::fmt;
 use std::ops::Deref;
+use std::rc::Rc;
 
 use crate::bbox::BoundingBox;
 use crate::cond::{RequiredExtensions, RequiredFeatures, SystemLanguage};
@@ -103,7 +104,7 @@ pub struct ElementInner<T: SetAttributes + Draw> {
     important_styles: HashSet<QualName>,
     result: ElementResult,
     transform: Transform,
-    values: ComputedValues,
+    values: Rc<ComputedValues>,
     cond: bool,
     style_attr: String,
     pub element_impl: T,
@@ -130,7 +131,7 @@ impl<T: SetAttributes + Draw> ElementInner<T> {
         &self.values
     }
 
-    fn set_computed_values(&mut self, values: &ComputedValues) {
+    fn set_computed_values(&mut self, values: &Rc<ComputedValues>) {
         self.values = values.clone();
     }
 
@@ -527,7 +528,7 @@ impl Element {
         call_inner!(self, get_computed_values)
     }
 
-    pub fn set_computed_values(&mut self, values: &ComputedValues) {
+    pub fn set_computed_values(&mut self, values: &Rc<ComputedValues>) {
         call_inner!(self, set_computed_values, values);
     }
 
@@ -638,7 +639,7 @@ macro_rules! e {
                 important_styles: Default::default(),
                 transform: Default::default(),
                 result: Ok(()),
-                values: ComputedValues::default(),
+                values: Rc::new(ComputedValues::default()),
                 cond: true,
                 style_attr: String::new(),
                 element_impl: <$element_type>::default(),
@@ -8,7 +8,7 @@ use crate::element::{ElementResult, SetAttributes};
 use crate::error::*;
 use crate::node::Node;
 use crate::number_list::{NumberList, NumberListLength};
-use crate::parsers::{Parse, ParseValue};
+use crate::parsers::{CustomIdent, Parse, ParseValue};
 use crate::property_bag::PropertyBag;
 use crate::surface_utils::{
     iterators::Pixels, shared_surface::ExclusiveImageSurface, ImageSurfaceDataExt, Pixel,
@@ -16,7 +16,7 @@ use crate::surface_utils::{
 use crate::util::clamp;
 
 use super::context::{FilterContext, FilterOutput, FilterResult};
-use super::{FilterEffect, FilterError, PrimitiveWithInput};
+use super::{FilterEffect, FilterError, Input, PrimitiveWithInput};
 
 /// Color matrix operation types.
 #[derive(Debug, Clone, Copy, Eq, PartialEq)]
@@ -215,6 +215,14 @@ impl FilterEffect for FeColorMatrix {
     fn is_affected_by_color_interpolation_filters(&self) -> bool {
         true
     }
+
+    fn result_name(&self) -> Option<&CustomIdent> {
+        self.base.base.result.as_ref()
+    }
+
+    fn inputs(&self, _node: &Node) -> Vec<Option<Input>> {
+        vec![self.base.in_.clone()]
+    }
 }
 
 impl Parse for OperationType {
@@ -9,7 +9,7 @@ use crate::element::{Draw, Element, ElementResult, SetAttributes};
 use crate::error::*;
 use crate::node::{Node, NodeBorrow};
 use crate::number_list::{NumberList, NumberListLength};
-use crate::parsers::{Parse, ParseValue};
+use crate::parsers::{CustomIdent, Parse, ParseValue};
 use crate::property_bag::PropertyBag;
 use crate::surface_utils::{
     iterators::Pixels, shared_surface::ExclusiveImageSurface, ImageSurfaceDataExt, Pixel,
@@ -17,7 +17,7 @@ use crate::surface_utils::{
 use crate::util::clamp;
 
 use super::context::{FilterContext, FilterOutput, FilterResult};
-use super::{FilterEffect, FilterError, PrimitiveWithInput};
+use super::{FilterEffect, FilterError, Input, PrimitiveWithInput};
 
 /// The `feComponentTransfer` filter primitive.
 pub struct FeComponentTransfer {
@@ -388,4 +388,12 @@ impl FilterEffect for FeComponentTransfer {
     fn is_affected_by_color_interpolation_filters(&self) -> bool {
         true
     }
+
+    fn result_name(&self) -> Option<&CustomIdent> {
+        self.base.base.result.as_ref()
+    }
+
+    fn inputs(&self, _node: &Node) -> Vec<Option<Input>> {
+        vec![self.base.in_.clone()]
+    }
 }
@@ -6,7 +6,7 @@ use crate::drawing_ctx::DrawingCtx;
 use crate::element::{ElementResult, SetAttributes};
 use crate::error::*;
 use crate::node::Node;
-use crate::parsers::{Parse, ParseValue};
+use crate::parsers::{CustomIdent, Parse, ParseValue};
 use crate::property_bag::PropertyBag;
 
 use super::context::{FilterContext, FilterOutput, FilterResult};
@@ -114,6 +114,14 @@ impl FilterEffect for FeComposite {
     fn is_affected_by_color_interpolation_filters(&self) -> bool {
         true
     }
+
+    fn result_name(&self) -> Option<&CustomIdent> {
+        self.base.base.result.as_ref()
+    }
+
+    fn inputs(&self, _node: &Node) -> Vec<Option<Input>> {
+        vec![self.base.in_.clone(), self.in2.clone()]
+    }
 }
 
 impl Parse for Operator {
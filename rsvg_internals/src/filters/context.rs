@@ -215,9 +215,19 @@ impl FilterContext {
     /// The returned surface is in the sRGB color space.
     // TODO: sRGB conversion should probably be done by the caller.
     #[inline]
-    pub fn into_output(self) -> Result<SharedImageSurface, cairo::Status> {
-        match self.last_result {
-            Some(FilterOutput { surface, bounds }) => surface.to_srgb(bounds),
+    pub fn into_output(mut self) -> Result<SharedImageSurface, cairo::Status> {
+        // Offer the intermediate surfaces for reuse by later filter chains; only
+        // surfaces with no references left elsewhere actually get pooled.
+        for (_, output) in self.previous_results.drain() {
+            output.surface.recycle();
+        }
+
+        match self.last_result.take() {
+            Some(FilterOutput { surface, bounds }) => {
+                let output = surface.to_srgb(bounds)?;
+                surface.recycle();
+                Ok(output)
+            }
             None => SharedImageSurface::empty(
                 self.source_surface.width(),
                 self.source_surface.height(),
@@ -233,7 +243,12 @@ impl FilterContext {
             self.previous_results.insert(name, result.output.clone());
         }
 
-        self.last_result = Some(result.output);
+        if let Some(FilterOutput { surface, .. }) = self.last_result.replace(result.output) {
+            // A previous unnamed result can't be referenced anymore; offer its
+            // surface for reuse by subsequent primitives.
+            surface.recycle();
+        }
+
         Ok(())
     }
 
@@ -1,6 +1,6 @@
 use cssparser::Parser;
 use markup5ever::{expanded_name, local_name, namespace_url, ns, QualName};
-use nalgebra::{DMatrix, Dynamic, VecStorage};
+use nalgebra::{storage::Storage, DMatrix, Dim, Dynamic, Matrix, Matrix3, Matrix5, VecStorage};
 
 use crate::document::AcquiredNodes;
 use crate::drawing_ctx::DrawingCtx;
@@ -8,18 +8,18 @@ use crate::element::{ElementResult, SetAttributes};
 use crate::error::*;
 use crate::node::Node;
 use crate::number_list::{NumberList, NumberListLength};
-use crate::parsers::{NumberOptionalNumber, Parse, ParseValue};
+use crate::parsers::{CustomIdent, NumberOptionalNumber, Parse, ParseValue};
 use crate::property_bag::PropertyBag;
 use crate::rect::IRect;
 use crate::surface_utils::{
     iterators::{PixelRectangle, Pixels},
-    shared_surface::ExclusiveImageSurface,
+    shared_surface::{ExclusiveImageSurface, SharedImageSurface},
     EdgeMode, ImageSurfaceDataExt, Pixel,
 };
 use crate::util::clamp;
 
 use super::context::{FilterContext, FilterOutput, FilterResult};
-use super::{FilterEffect, FilterError, PrimitiveWithInput};
+use super::{FilterEffect, FilterError, Input, PrimitiveWithInput};
 
 /// The `feConvolveMatrix` filter primitive.
 pub struct FeConvolveMatrix {
@@ -193,6 +193,109 @@ impl SetAttributes for FeConvolveMatrix {
     }
 }
 
+impl FeConvolveMatrix {
+    /// Runs the per-pixel convolution, generic over the kernel matrix dimensions.
+    ///
+    /// Pixels whose kernel rectangle lies fully inside `bounds` take a fast path with
+    /// direct pixel access; the edge handling through `PixelRectangle` only runs for the
+    /// border pixels.
+    fn convolution_loop<R: Dim, C: Dim, S: Storage<f64, R, C>>(
+        &self,
+        input_surface: &SharedImageSurface,
+        bounds: IRect,
+        matrix: &Matrix<f64, R, C, S>,
+        data: &mut cairo::ImageSurfaceData,
+        stride: usize,
+    ) {
+        for (x, y, pixel) in Pixels::within(input_surface, bounds) {
+            // Compute the convolution rectangle bounds.
+            let kernel_bounds = IRect::new(
+                x as i32 - self.target_x.unwrap() as i32,
+                y as i32 - self.target_y.unwrap() as i32,
+                x as i32 - self.target_x.unwrap() as i32 + self.order.0 as i32,
+                y as i32 - self.target_y.unwrap() as i32 + self.order.1 as i32,
+            );
+
+            // Do the convolution.
+            let mut r = 0.0;
+            let mut g = 0.0;
+            let mut b = 0.0;
+            let mut a = 0.0;
+
+            if bounds.contains(kernel_bounds.x0, kernel_bounds.y0)
+                && bounds.contains(kernel_bounds.x1 - 1, kernel_bounds.y1 - 1)
+            {
+                // The whole kernel is inside the bounds: no edge handling needed. The
+                // loop bounds are compile-time constants for the statically-sized
+                // kernels, so this loop nest unrolls fully.
+                for kernel_y in 0..matrix.nrows() {
+                    for kernel_x in 0..matrix.ncols() {
+                        let x = (kernel_bounds.x1 - 1 - kernel_x as i32) as u32;
+                        let y = (kernel_bounds.y1 - 1 - kernel_y as i32) as u32;
+                        let pixel = input_surface.get_pixel(x, y);
+
+                        let factor = matrix[(kernel_y, kernel_x)];
+
+                        r += f64::from(pixel.r) / 255.0 * factor;
+                        g += f64::from(pixel.g) / 255.0 * factor;
+                        b += f64::from(pixel.b) / 255.0 * factor;
+
+                        if !self.preserve_alpha {
+                            a += f64::from(pixel.a) / 255.0 * factor;
+                        }
+                    }
+                }
+            } else {
+                for (x, y, pixel) in
+                    PixelRectangle::within(input_surface, bounds, kernel_bounds, self.edge_mode)
+                {
+                    let kernel_x = (kernel_bounds.x1 - x - 1) as usize;
+                    let kernel_y = (kernel_bounds.y1 - y - 1) as usize;
+
+                    r += f64::from(pixel.r) / 255.0 * matrix[(kernel_y, kernel_x)];
+                    g += f64::from(pixel.g) / 255.0 * matrix[(kernel_y, kernel_x)];
+                    b += f64::from(pixel.b) / 255.0 * matrix[(kernel_y, kernel_x)];
+
+                    if !self.preserve_alpha {
+                        a += f64::from(pixel.a) / 255.0 * matrix[(kernel_y, kernel_x)];
+                    }
+                }
+            }
+
+            // If preserve_alpha is true, set a to the source alpha value.
+            if self.preserve_alpha {
+                a = f64::from(pixel.a) / 255.0;
+            } else {
+                a = a / self.divisor.unwrap() + self.bias;
+            }
+
+            let clamped_a = clamp(a, 0.0, 1.0);
+
+            let compute = |x| {
+                let x = x / self.divisor.unwrap() + self.bias * a;
+
+                let x = if self.preserve_alpha {
+                    // Premultiply the output value.
+                    clamp(x, 0.0, 1.0) * clamped_a
+                } else {
+                    clamp(x, 0.0, clamped_a)
+                };
+
+                ((x * 255.0) + 0.5) as u8
+            };
+
+            let output_pixel = Pixel {
+                r: compute(r),
+                g: compute(g),
+                b: compute(b),
+                a: ((clamped_a * 255.0) + 0.5) as u8,
+            };
+
+            data.set_pixel(stride, output_pixel, x, y);
+        }
+    }
+}
+
 impl FilterEffect for FeConvolveMatrix {
     fn render(
         &self,
@@ -237,66 +340,19 @@ impl FilterEffect for FeConvolveMatrix {
         )?;
 
         surface.modify(&mut |data, stride| {
-            for (x, y, pixel) in Pixels::within(&input_surface, bounds) {
-                // Compute the convolution rectangle bounds.
-                let kernel_bounds = IRect::new(
-                    x as i32 - self.target_x.unwrap() as i32,
-                    y as i32 - self.target_y.unwrap() as i32,
-                    x as i32 - self.target_x.unwrap() as i32 + self.order.0 as i32,
-                    y as i32 - self.target_y.unwrap() as i32 + self.order.1 as i32,
-                );
-
-                // Do the convolution.
-                let mut r = 0.0;
-                let mut g = 0.0;
-                let mut b = 0.0;
-                let mut a = 0.0;
-
-                for (x, y, pixel) in
-                    PixelRectangle::within(&input_surface, bounds, kernel_bounds, self.edge_mode)
-                {
-                    let kernel_x = (kernel_bounds.x1 - x - 1) as usize;
-                    let kernel_y = (kernel_bounds.y1 - y - 1) as usize;
-
-                    r += f64::from(pixel.r) / 255.0 * matrix[(kernel_y, kernel_x)];
-                    g += f64::from(pixel.g) / 255.0 * matrix[(kernel_y, kernel_x)];
-                    b += f64::from(pixel.b) / 255.0 * matrix[(kernel_y, kernel_x)];
-
-                    if !self.preserve_alpha {
-                        a += f64::from(pixel.a) / 255.0 * matrix[(kernel_y, kernel_x)];
-                    }
+            // Dispatch the overwhelmingly common small orders to statically-sized
+            // kernels. With the dimensions known at compile time the inner loops get
+            // fully unrolled and vectorized.
+            match self.order {
+                (3, 3) => {
+                    let kernel = Matrix3::from_fn(|r, c| matrix[(r, c)]);
+                    self.convolution_loop(&input_surface, bounds, &kernel, data, stride);
                 }
-
-                // If preserve_alpha is true, set a to the source alpha value.
-                if self.preserve_alpha {
-                    a = f64::from(pixel.a) / 255.0;
-                } else {
-                    a = a / self.divisor.unwrap() + self.bias;
+                (5, 5) => {
+                    let kernel = Matrix5::from_fn(|r, c| matrix[(r, c)]);
+                    self.convolution_loop(&input_surface, bounds, &kernel, data, stride);
                 }
-
-                let clamped_a = clamp(a, 0.0, 1.0);
-
-                let compute = |x| {
-                    let x = x / self.divisor.unwrap() + self.bias * a;
-
-                    let x = if self.preserve_alpha {
-                        // Premultiply the output value.
-                        clamp(x, 0.0, 1.0) * clamped_a
-                    } else {
-                        clamp(x, 0.0, clamped_a)
-                    };
-
-                    ((x * 255.0) + 0.5) as u8
-                };
-
-                let output_pixel = Pixel {
-                    r: compute(r),
-                    g: compute(g),
-                    b: compute(b),
-                    a: ((clamped_a * 255.0) + 0.5) as u8,
-                };
-
-                data.set_pixel(stride, output_pixel, x, y);
+                _ => self.convolution_loop(&input_surface, bounds, matrix, data, stride),
             }
         });
 
@@ -325,6 +381,14 @@ impl FilterEffect for FeConvolveMatrix {
     fn is_affected_by_color_interpolation_filters(&self) -> bool {
         true
     }
+
+    fn result_name(&self) -> Option<&CustomIdent> {
+        self.base.base.result.as_ref()
+    }
+
+    fn inputs(&self, _node: &Node) -> Vec<Option<Input>> {
+        vec![self.base.in_.clone()]
+    }
 }
 
 impl Parse for EdgeMode {
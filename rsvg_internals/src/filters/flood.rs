@@ -5,7 +5,9 @@ use crate::node::{CascadedValues, Node};
 use crate::property_bag::PropertyBag;
 
 use super::context::{FilterContext, FilterOutput, FilterResult};
-use super::{FilterEffect, FilterError, Primitive};
+use super::{FilterEffect, FilterError, Input, Primitive};
+
+use crate::parsers::CustomIdent;
 
 /// The `feFlood` filter primitive.
 pub struct FeFlood {
@@ -62,4 +64,12 @@ impl FilterEffect for FeFlood {
     fn is_affected_by_color_interpolation_filters(&self) -> bool {
         false
     }
+
+    fn result_name(&self) -> Option<&CustomIdent> {
+        self.base.result.as_ref()
+    }
+
+    fn inputs(&self, _node: &Node) -> Vec<Option<Input>> {
+        Vec::new()
+    }
 }
@@ -7,13 +7,13 @@ use crate::drawing_ctx::DrawingCtx;
 use crate::element::{ElementResult, SetAttributes};
 use crate::error::*;
 use crate::node::{CascadedValues, Node};
-use crate::parsers::ParseValue;
+use crate::parsers::{CustomIdent, ParseValue};
 use crate::property_bag::PropertyBag;
 use crate::rect::Rect;
 use crate::viewbox::ViewBox;
 
 use super::context::{FilterContext, FilterOutput, FilterResult};
-use super::{FilterEffect, FilterError, Primitive};
+use super::{FilterEffect, FilterError, Input, Primitive};
 
 /// The `feImage` filter primitive.
 pub struct FeImage {
@@ -168,4 +168,12 @@ impl FilterEffect for FeImage {
     fn is_affected_by_color_interpolation_filters(&self) -> bool {
         false
     }
+
+    fn result_name(&self) -> Option<&CustomIdent> {
+        self.base.result.as_ref()
+    }
+
+    fn inputs(&self, _node: &Node) -> Vec<Option<Input>> {
+        Vec::new()
+    }
 }
@@ -13,10 +13,10 @@ use crate::element::{Draw, Element, ElementResult, SetAttributes};
 use crate::error::*;
 use crate::filters::{
     context::{FilterContext, FilterOutput, FilterResult},
-    FilterEffect, FilterError, PrimitiveWithInput,
+    FilterEffect, FilterError, Input, PrimitiveWithInput,
 };
 use crate::node::{CascadedValues, Node, NodeBorrow};
-use crate::parsers::{NumberOptionalNumber, ParseValue};
+use crate::parsers::{CustomIdent, NumberOptionalNumber, ParseValue};
 use crate::property_bag::PropertyBag;
 use crate::rect::IRect;
 use crate::surface_utils::{
@@ -520,15 +520,32 @@ macro_rules! impl_lighting_filter {
                     let mut output_data = surface.get_data();
                     let output_slice = &mut *output_data;
 
+                    // A distant light has the same light vector for every pixel (and
+                    // hence the same color, since only spot lights attenuate), so
+                    // compute them once instead of redoing the trigonometry per pixel.
+                    let constant_light = match light_source {
+                        LightSource::Distant { .. } => {
+                            let vector = light_source.vector(0.0, 0.0, 0.0);
+                            Some((vector, light_source.color(lighting_color, vector)))
+                        }
+                        _ => None,
+                    };
+
                     let compute_output_pixel =
                         |mut output_slice: &mut [u8], base_y, x, y, normal: Normal| {
                             let pixel = input_surface.get_pixel(x, y);
 
-                            let scaled_x = f64::from(x) * ox;
-                            let scaled_y = f64::from(y) * oy;
-                            let z = f64::from(pixel.a) / 255.0 * self.common().surface_scale;
-                            let light_vector = light_source.vector(scaled_x, scaled_y, z);
-                            let light_color = light_source.color(lighting_color, light_vector);
+                            let (light_vector, light_color) = match constant_light {
+                                Some((vector, color)) => (vector, color),
+                                None => {
+                                    let scaled_x = f64::from(x) * ox;
+                                    let scaled_y = f64::from(y) * oy;
+                                    let z =
+                                        f64::from(pixel.a) / 255.0 * self.common().surface_scale;
+                                    let vector = light_source.vector(scaled_x, scaled_y, z);
+                                    (vector, light_source.color(lighting_color, vector))
+                                }
+                            };
 
                             // compute the factor just once for the three colors
                             let factor = self.compute_factor(normal, light_vector);
@@ -678,6 +695,14 @@ macro_rules! impl_lighting_filter {
             fn is_affected_by_color_interpolation_filters(&self) -> bool {
                 true
             }
+
+            fn result_name(&self) -> Option<&CustomIdent> {
+                self.common().base.base.result.as_ref()
+            }
+
+            fn inputs(&self, _node: &Node) -> Vec<Option<Input>> {
+                vec![self.common().base.in_.clone()]
+            }
         }
     };
 }
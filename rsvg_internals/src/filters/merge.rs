@@ -4,7 +4,7 @@ use crate::document::AcquiredNodes;
 use crate::drawing_ctx::DrawingCtx;
 use crate::element::{Draw, Element, ElementResult, SetAttributes};
 use crate::node::{Node, NodeBorrow};
-use crate::parsers::ParseValue;
+use crate::parsers::{CustomIdent, ParseValue};
 use crate::property_bag::PropertyBag;
 use crate::rect::IRect;
 use crate::surface_utils::shared_surface::{SharedImageSurface, SurfaceType};
@@ -135,4 +135,21 @@ impl FilterEffect for FeMerge {
     fn is_affected_by_color_interpolation_filters(&self) -> bool {
         true
     }
+
+    fn result_name(&self) -> Option<&CustomIdent> {
+        self.base.result.as_ref()
+    }
+
+    fn inputs(&self, node: &Node) -> Vec<Option<Input>> {
+        node.children()
+            .filter(|c| c.is_element())
+            .filter_map(|c| {
+                if let Element::FeMergeNode(ref merge_node) = *c.borrow_element() {
+                    Some(merge_node.in_.clone())
+                } else {
+                    None
+                }
+            })
+            .collect()
+    }
 }
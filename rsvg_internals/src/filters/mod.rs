@@ -48,6 +48,17 @@ pub trait FilterEffect: SetAttributes + Draw {
     /// Primitives that do color blending (like `feComposite` or `feBlend`) should return `true`
     /// here, whereas primitives that don't (like `feOffset`) should return `false`.
     fn is_affected_by_color_interpolation_filters(&self) -> bool;
+
+    /// Returns the name in this primitive's `result` attribute, if any.
+    fn result_name(&self) -> Option<&CustomIdent>;
+
+    /// Returns this primitive's inputs, for building the dependency graph among the
+    /// primitives of a filter.
+    ///
+    /// A `None` entry stands for an unspecified `in` attribute, which refers to the
+    /// result of the previous primitive.  `node` is the primitive's element;
+    /// `feMerge` reads its inputs from its `feMergeNode` children.
+    fn inputs(&self, node: &Node) -> Vec<Option<Input>>;
 }
 
 // Filter Effects do not need to draw themselves
@@ -323,15 +334,31 @@ pub fn render(
             };
 
             (c, linear_rgb)
-        });
+        })
+        .collect::<Vec<_>>();
+
+    // Determine which primitives actually contribute to the filter's output.  The
+    // last primitive produces the output; everything else is only needed if a live
+    // primitive consumes its result, either through an explicit "in"/"in2"
+    // reference or as the implicit "result of the previous primitive".  Dangling
+    // sub-chains are skipped entirely.
+    let live = compute_live_primitives(&primitives);
+
+    for (i, (c, linear_rgb)) in primitives.iter().enumerate() {
+        if !live[i] {
+            rsvg_log!(
+                "(skipping filter primitive {} because nothing references its result)",
+                c
+            );
+            continue;
+        }
 
-    for (c, linear_rgb) in primitives {
         let elt = c.borrow_element();
         let filter = elt.as_filter_effect().unwrap();
 
         let mut render = |filter_ctx: &mut FilterContext| {
             if let Err(err) = filter
-                .render(&c, filter_ctx, acquired_nodes, draw_ctx)
+                .render(c, filter_ctx, acquired_nodes, draw_ctx)
                 .and_then(|result| filter_ctx.store_result(result))
             {
                 rsvg_log!("(filter primitive {} returned an error: {})", c, err);
@@ -347,23 +374,86 @@ pub fn render(
 
         let start = Instant::now();
 
-        if filter.is_affected_by_color_interpolation_filters() && linear_rgb {
+        if filter.is_affected_by_color_interpolation_filters() && *linear_rgb {
             filter_ctx.with_linear_rgb(render)?;
         } else {
             render(&mut filter_ctx)?;
         }
 
         let elapsed = start.elapsed();
-        rsvg_log!(
-            "(rendered filter primitive {} in\n    {} seconds)",
-            c,
-            elapsed.as_secs() as f64 + f64::from(elapsed.subsec_nanos()) / 1e9
-        );
+        let seconds = elapsed.as_secs() as f64 + f64::from(elapsed.subsec_nanos()) / 1e9;
+        rsvg_log!("(rendered filter primitive {} in\n    {} seconds)", c, seconds);
+
+        {
+            let mut stats = draw_ctx.stats_mut();
+
+            stats.filter_primitives += 1;
+            stats.filter_elapsed += seconds;
+
+            // Each primitive's stored result is a surface the size of the
+            // source graphic.
+            stats.count_temporary_surface(
+                filter_ctx.source_graphic().width(),
+                filter_ctx.source_graphic().height(),
+            );
+        }
     }
 
     Ok(filter_ctx.into_output()?)
 }
 
+/// Marks the primitives that contribute to the filter's output.
+///
+/// Starting from the last primitive, this follows each live primitive's inputs
+/// backwards: an explicit `FilterOutput` reference resolves to the nearest earlier
+/// primitive with that `result` name, and an unspecified input refers to the
+/// previous primitive.  Standard inputs like `SourceGraphic` add no edges.
+fn compute_live_primitives(primitives: &[(Node, bool)]) -> Vec<bool> {
+    let mut live = vec![false; primitives.len()];
+
+    if primitives.is_empty() {
+        return live;
+    }
+
+    let mut stack = vec![primitives.len() - 1];
+
+    while let Some(i) = stack.pop() {
+        if live[i] {
+            continue;
+        }
+
+        live[i] = true;
+
+        let elt = primitives[i].0.borrow_element();
+        let filter = elt.as_filter_effect().unwrap();
+
+        for input in filter.inputs(&primitives[i].0) {
+            match input {
+                Some(Input::FilterOutput(ref name)) => {
+                    if let Some(j) = (0..i).rev().find(|&j| {
+                        let elt = primitives[j].0.borrow_element();
+                        elt.as_filter_effect().unwrap().result_name() == Some(name)
+                    }) {
+                        stack.push(j);
+                    }
+                }
+
+                // Standard input like SourceGraphic; no primitive involved.
+                Some(_) => (),
+
+                // Unspecified input; refers to the previous primitive's result.
+                None => {
+                    if i > 0 {
+                        stack.push(i - 1);
+                    }
+                }
+            }
+        }
+    }
+
+    live
+}
+
 impl From<ColorInterpolationFilters> for SurfaceType {
     fn from(c: ColorInterpolationFilters) -> Self {
         match c {
@@ -8,7 +8,7 @@ use crate::drawing_ctx::DrawingCtx;
 use crate::element::{ElementResult, SetAttributes};
 use crate::error::*;
 use crate::node::Node;
-use crate::parsers::{NumberOptionalNumber, Parse, ParseValue};
+use crate::parsers::{CustomIdent, NumberOptionalNumber, Parse, ParseValue};
 use crate::property_bag::PropertyBag;
 use crate::rect::IRect;
 use crate::surface_utils::{
@@ -18,7 +18,7 @@ use crate::surface_utils::{
 };
 
 use super::context::{FilterContext, FilterOutput, FilterResult};
-use super::{FilterEffect, FilterError, PrimitiveWithInput};
+use super::{FilterEffect, FilterError, Input, PrimitiveWithInput};
 
 /// Enumeration of the possible morphology operations.
 enum Operator {
@@ -153,6 +153,14 @@ impl FilterEffect for FeMorphology {
     fn is_affected_by_color_interpolation_filters(&self) -> bool {
         false
     }
+
+    fn result_name(&self) -> Option<&CustomIdent> {
+        self.base.base.result.as_ref()
+    }
+
+    fn inputs(&self, _node: &Node) -> Vec<Option<Input>> {
+        vec![self.base.in_.clone()]
+    }
 }
 
 impl Parse for Operator {
@@ -4,11 +4,11 @@ use crate::document::AcquiredNodes;
 use crate::drawing_ctx::DrawingCtx;
 use crate::element::{ElementResult, SetAttributes};
 use crate::node::Node;
-use crate::parsers::ParseValue;
+use crate::parsers::{CustomIdent, ParseValue};
 use crate::property_bag::PropertyBag;
 
 use super::context::{FilterContext, FilterOutput, FilterResult};
-use super::{FilterEffect, FilterError, PrimitiveWithInput};
+use super::{FilterEffect, FilterError, Input, PrimitiveWithInput};
 
 /// The `feOffset` filter primitive.
 pub struct FeOffset {
@@ -74,4 +74,12 @@ impl FilterEffect for FeOffset {
     fn is_affected_by_color_interpolation_filters(&self) -> bool {
         false
     }
+
+    fn result_name(&self) -> Option<&CustomIdent> {
+        self.base.base.result.as_ref()
+    }
+
+    fn inputs(&self, _node: &Node) -> Vec<Option<Input>> {
+        vec![self.base.in_.clone()]
+    }
 }
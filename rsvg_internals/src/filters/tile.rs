@@ -5,7 +5,9 @@ use crate::node::Node;
 use crate::property_bag::PropertyBag;
 
 use super::context::{FilterContext, FilterInput, FilterOutput, FilterResult};
-use super::{FilterEffect, FilterError, PrimitiveWithInput};
+use super::{FilterEffect, FilterError, Input, PrimitiveWithInput};
+
+use crate::parsers::CustomIdent;
 
 /// The `feTile` filter primitive.
 pub struct FeTile {
@@ -71,4 +73,12 @@ impl FilterEffect for FeTile {
     fn is_affected_by_color_interpolation_filters(&self) -> bool {
         false
     }
+
+    fn result_name(&self) -> Option<&CustomIdent> {
+        self.base.base.result.as_ref()
+    }
+
+    fn inputs(&self, _node: &Node) -> Vec<Option<Input>> {
+        vec![self.base.in_.clone()]
+    }
 }
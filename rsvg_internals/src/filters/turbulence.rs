@@ -1,12 +1,13 @@
 use cssparser::Parser;
 use markup5ever::{expanded_name, local_name, namespace_url, ns};
+use rayon::prelude::*;
 
 use crate::document::AcquiredNodes;
 use crate::drawing_ctx::DrawingCtx;
 use crate::element::{ElementResult, SetAttributes};
 use crate::error::*;
 use crate::node::{CascadedValues, Node};
-use crate::parsers::{NumberOptionalNumber, Parse, ParseValue};
+use crate::parsers::{CustomIdent, NumberOptionalNumber, Parse, ParseValue};
 use crate::property_bag::PropertyBag;
 use crate::surface_utils::{
     shared_surface::{ExclusiveImageSurface, SurfaceType},
@@ -15,7 +16,7 @@ use crate::surface_utils::{
 use crate::util::clamp;
 
 use super::context::{FilterContext, FilterOutput, FilterResult};
-use super::{FilterEffect, FilterError, Primitive};
+use super::{FilterEffect, FilterError, Input, Primitive};
 
 /// Enumeration of the tile stitching modes.
 #[derive(Debug, Clone, Copy, Eq, PartialEq, Hash)]
@@ -366,39 +367,53 @@ impl FilterEffect for FeTurbulence {
             surface_type,
         )?;
 
+        let type_ = self.type_;
+
         surface.modify(&mut |data, stride| {
-            for y in bounds.y_range() {
-                for x in bounds.x_range() {
-                    let point = affine.transform_point(f64::from(x), f64::from(y));
-                    let point = [point.0, point.1];
-
-                    let generate = |color_channel| {
-                        let v = noise_generator.turbulence(
-                            color_channel,
-                            point,
-                            f64::from(x - bounds.x0),
-                            f64::from(y - bounds.y0),
-                        );
-
-                        let v = match self.type_ {
-                            NoiseType::FractalNoise => (v * 255.0 + 255.0) / 2.0,
-                            NoiseType::Turbulence => v * 255.0,
+            // Generate the noise row by row on the rayon thread pool: every output
+            // pixel is computed independently of the others.
+            let first_row = bounds.y0 as usize;
+            let one_past_last_row = bounds.y1 as usize;
+
+            let slice = &mut data[first_row * stride..one_past_last_row * stride];
+
+            slice
+                .par_chunks_mut(stride)
+                .zip(bounds.y_range())
+                .for_each(|(row, y)| {
+                    let mut row = row;
+
+                    for x in bounds.x_range() {
+                        let point = affine.transform_point(f64::from(x), f64::from(y));
+                        let point = [point.0, point.1];
+
+                        let generate = |color_channel| {
+                            let v = noise_generator.turbulence(
+                                color_channel,
+                                point,
+                                f64::from(x - bounds.x0),
+                                f64::from(y - bounds.y0),
+                            );
+
+                            let v = match type_ {
+                                NoiseType::FractalNoise => (v * 255.0 + 255.0) / 2.0,
+                                NoiseType::Turbulence => v * 255.0,
+                            };
+
+                            (clamp(v, 0.0, 255.0) + 0.5) as u8
                         };
 
-                        (clamp(v, 0.0, 255.0) + 0.5) as u8
-                    };
+                        let pixel = Pixel {
+                            r: generate(0),
+                            g: generate(1),
+                            b: generate(2),
+                            a: generate(3),
+                        }
+                        .premultiply();
 
-                    let pixel = Pixel {
-                        r: generate(0),
-                        g: generate(1),
-                        b: generate(2),
-                        a: generate(3),
+                        row.set_pixel(stride, pixel, x as u32, 0);
                     }
-                    .premultiply();
-
-                    data.set_pixel(stride, pixel, x as u32, y as u32);
-                }
-            }
+                });
         });
 
         Ok(FilterResult {
@@ -414,6 +429,14 @@ impl FilterEffect for FeTurbulence {
     fn is_affected_by_color_interpolation_filters(&self) -> bool {
         true
     }
+
+    fn result_name(&self) -> Option<&CustomIdent> {
+        self.base.result.as_ref()
+    }
+
+    fn inputs(&self, _node: &Node) -> Vec<Option<Input>> {
+        Vec::new()
+    }
 }
 
 impl Parse for StitchTiles {
@@ -6,6 +6,7 @@ use markup5ever::{
 };
 use matches::matches;
 use std::cell::RefCell;
+use std::collections::HashMap;
 
 use crate::allowed_url::Fragment;
 use crate::bbox::*;
@@ -41,7 +42,7 @@ struct ColorStop {
 coord_units!(GradientUnits, CoordUnits::ObjectBoundingBox);
 
 /// spreadMethod attribute for gradients
-#[derive(Debug, Copy, Clone, PartialEq)]
+#[derive(Debug, Copy, Clone, PartialEq, Eq, Hash)]
 enum SpreadMethod {
     Pad,
     Reflect,
@@ -724,6 +725,33 @@ impl_paint_source!(LinearGradient, RadialGradient);
 
 impl_paint_source!(RadialGradient, LinearGradient);
 
+/// Cache key for constructed cairo gradient patterns.
+///
+/// Design-tool documents reference a single gradient from hundreds of shapes,
+/// so after the initial resolution the remaining per-use cost is building the
+/// cairo pattern and re-adding every color stop.  The key captures all of the
+/// pattern's inputs: the normalized gradient geometry, the user-space transform
+/// it will be drawn with, the spread method, the stops, and the layered
+/// opacity.  Floats are keyed as raw bits.
+#[derive(PartialEq, Eq, Hash)]
+struct PatternKey {
+    geometry: [u64; 6],
+    is_radial: bool,
+    spread: SpreadMethod,
+    transform: [u64; 6],
+    opacity: u64,
+    stops: Vec<(u64, (u8, u8, u8, u8), u64)>,
+}
+
+// cairo patterns are not Send, so the cache is thread-local.  Cached patterns
+// are fully constructed and never mutated again; hits just take a reference.
+thread_local! {
+    static PATTERN_CACHE: RefCell<HashMap<PatternKey, cairo::Gradient>> =
+        RefCell::new(HashMap::new());
+}
+
+const PATTERN_CACHE_MAX_ENTRIES: usize = 64;
+
 impl AsPaintSource for Gradient {
     fn set_as_paint_source(
         self,
@@ -740,6 +768,14 @@ impl AsPaintSource for Gradient {
                 draw_ctx.get_view_params()
             };
 
+            let key = self.pattern_cache_key(values, &params, &transform, opacity);
+
+            if let Some(p) = PATTERN_CACHE.with(|cache| cache.borrow().get(&key).cloned()) {
+                let cr = draw_ctx.get_cairo_context();
+                cr.set_source(&p);
+                return Ok(true);
+            }
+
             let p = match self.variant {
                 Variant::Linear { .. } => {
                     let g = self.variant.to_cairo_gradient(values, &params);
@@ -754,6 +790,14 @@ impl AsPaintSource for Gradient {
 
             self.set_on_cairo_pattern(&p, &transform, opacity);
 
+            PATTERN_CACHE.with(|cache| {
+                let mut cache = cache.borrow_mut();
+                if cache.len() >= PATTERN_CACHE_MAX_ENTRIES {
+                    cache.clear();
+                }
+                cache.insert(key, cairo::Gradient::clone(&p));
+            });
+
             let cr = draw_ctx.get_cairo_context();
             cr.set_source(&p);
 
@@ -765,6 +809,80 @@ impl AsPaintSource for Gradient {
 }
 
 impl Gradient {
+    fn pattern_cache_key(
+        &self,
+        values: &ComputedValues,
+        params: &ViewParams,
+        transform: &Transform,
+        opacity: UnitInterval,
+    ) -> PatternKey {
+        let (geometry, is_radial) = match self.variant {
+            Variant::Linear { x1, y1, x2, y2 } => (
+                [
+                    x1.normalize(values, params).to_bits(),
+                    y1.normalize(values, params).to_bits(),
+                    x2.normalize(values, params).to_bits(),
+                    y2.normalize(values, params).to_bits(),
+                    0,
+                    0,
+                ],
+                false,
+            ),
+
+            Variant::Radial {
+                cx,
+                cy,
+                r,
+                fx,
+                fy,
+                fr,
+            } => (
+                [
+                    cx.normalize(values, params).to_bits(),
+                    cy.normalize(values, params).to_bits(),
+                    r.normalize(values, params).to_bits(),
+                    fx.normalize(values, params).to_bits(),
+                    fy.normalize(values, params).to_bits(),
+                    fr.normalize(values, params).to_bits(),
+                ],
+                true,
+            ),
+        };
+
+        let transform = transform.pre_transform(&self.transform);
+
+        PatternKey {
+            geometry,
+            is_radial,
+            spread: self.spread,
+            transform: [
+                transform.xx.to_bits(),
+                transform.yx.to_bits(),
+                transform.xy.to_bits(),
+                transform.yy.to_bits(),
+                transform.x0.to_bits(),
+                transform.y0.to_bits(),
+            ],
+            opacity: opacity.0.to_bits(),
+            stops: self
+                .stops
+                .iter()
+                .map(|stop| {
+                    (
+                        stop.offset.0.to_bits(),
+                        (
+                            stop.rgba.red,
+                            stop.rgba.green,
+                            stop.rgba.blue,
+                            stop.rgba.alpha,
+                        ),
+                        stop.opacity.0.to_bits(),
+                    )
+                })
+                .collect(),
+        }
+    }
+
     fn set_on_cairo_pattern(
         &self,
         pattern: &cairo::Gradient,
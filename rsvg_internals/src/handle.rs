@@ -2,17 +2,27 @@
 //!
 //! This module provides the primitives on which the public APIs are implemented.
 
+use std::cell::{Cell, RefCell};
+use std::collections::hash_map::DefaultHasher;
+use std::collections::HashMap;
+use std::hash::{Hash, Hasher};
+use std::sync::{Arc, Mutex};
+
+use gio::prelude::*;
+use once_cell::sync::Lazy;
+
 use crate::allowed_url::{AllowedUrl, Href};
 use crate::bbox::BoundingBox;
 use crate::css::{Origin, Stylesheet};
 use crate::document::{AcquiredNodes, Document};
 use crate::dpi::Dpi;
-use crate::drawing_ctx::DrawingCtx;
+use crate::drawing_ctx::{DrawingCtx, RenderStats};
 use crate::element::Element;
 use crate::error::{DefsLookupErrorKind, LoadingError, RenderingError};
 use crate::node::{CascadedValues, Node, NodeBorrow};
 use crate::rect::Rect;
 use crate::structure::IntrinsicDimensions;
+use crate::xml::XmlPushParser;
 use url::Url;
 
 /// Loading options for SVG documents.
@@ -26,6 +36,10 @@ pub struct LoadOptions {
 
     /// Whether to keep original (undecoded) image data to embed in Cairo PDF surfaces.
     pub keep_image_data: bool,
+
+    /// Whether to share parsed document data between handles through the
+    /// process-wide cache.
+    pub cache_document: bool,
 }
 
 impl LoadOptions {
@@ -35,6 +49,7 @@ impl LoadOptions {
             base_url,
             unlimited_size: false,
             keep_image_data: false,
+            cache_document: false,
         }
     }
 
@@ -56,6 +71,13 @@ impl LoadOptions {
         self
     }
 
+    /// Sets whether documents loaded by this handle may be shared through the
+    /// process-wide document cache.
+    pub fn cache_document(mut self, cache: bool) -> Self {
+        self.cache_document = cache;
+        self
+    }
+
     /// Creates a new `LoadOptions` with a different `base_url`.
     ///
     /// This is used when loading a referenced file that may in turn cause other files
@@ -65,10 +87,89 @@ impl LoadOptions {
             base_url: Some((**base_url).clone()),
             unlimited_size: self.unlimited_size,
             keep_image_data: self.keep_image_data,
+            cache_document: self.cache_document,
         }
     }
 }
 
+/// Retained result of a full-document render.
+///
+/// The first `render_document()` call records the fully resolved draw commands into a
+/// `cairo::RecordingSurface`, which stores them in vector form.  Subsequent calls with
+/// the same viewport and DPI replay the recording under whatever transform the caller's
+/// context carries, instead of walking the node tree and re-resolving lengths again.
+/// The document tree is immutable after loading, so the recording only needs to be
+/// discarded when `set_stylesheet()` re-runs the cascade.
+struct DisplayList {
+    surface: cairo::RecordingSurface,
+    viewport: Rect,
+    dpi: Dpi,
+    is_testing: bool,
+}
+
+impl DisplayList {
+    fn replay(&self, cr: &cairo::Context) -> Result<(), RenderingError> {
+        cr.save();
+        cr.set_source_surface(&self.surface, 0.0, 0.0);
+        cr.paint();
+        cr.restore();
+
+        check_cairo_context(cr)
+    }
+}
+
+/// Cache key for memoized geometry queries.
+///
+/// Computing an element's geometry effectively measures a full render, and
+/// sprite-sheet workflows query hundreds of ids per document.  The document is
+/// immutable after loading, so an element's ink and logical rects only depend
+/// on the id, the viewport, and the DPI; repeated queries with the same inputs
+/// can be answered from a map.  Viewport and DPI floats are keyed as raw bits.
+#[derive(PartialEq, Eq, Hash)]
+struct GeometryCacheKey {
+    id: Option<String>,
+    viewport: [u64; 4],
+    dpi: [u64; 2],
+    is_testing: bool,
+}
+
+impl GeometryCacheKey {
+    fn new(id: Option<&str>, viewport: Rect, dpi: Dpi, is_testing: bool) -> GeometryCacheKey {
+        GeometryCacheKey {
+            id: id.map(String::from),
+            viewport: [
+                viewport.x0.to_bits(),
+                viewport.y0.to_bits(),
+                viewport.x1.to_bits(),
+                viewport.y1.to_bits(),
+            ],
+            dpi: [dpi.x.to_bits(), dpi.y.to_bits()],
+            is_testing,
+        }
+    }
+}
+
+const GEOMETRY_CACHE_MAX_ENTRIES: usize = 1024;
+
+/// Process-wide cache of pre-parsed documents, behind `LoadOptions::cache_document`.
+///
+/// The node tree is built on `Rc` and cannot be shared between threads, so what
+/// gets shared is the serialized pre-parsed event stream that
+/// [`Handle::from_cache_data`] consumes: a hit skips XML parsing entirely, but
+/// each handle still builds its own tree.  Entries are keyed by a hash of the
+/// input bytes plus the parser limits in effect; the original bytes are kept
+/// alongside the entry and compared on lookup so a hash collision can never
+/// hand back the wrong document.
+struct CachedDocument {
+    content: Vec<u8>,
+    cache_data: Vec<u8>,
+}
+
+static DOCUMENT_CACHE: Lazy<Mutex<HashMap<(u64, bool), Arc<CachedDocument>>>> =
+    Lazy::new(|| Mutex::new(HashMap::new()));
+
+const DOCUMENT_CACHE_MAX_ENTRIES: usize = 64;
+
 /// Main handle to an SVG document.
 ///
 /// This is the main object in librsvg.  It gets created with the [`from_stream`] method
@@ -77,6 +178,9 @@ impl LoadOptions {
 /// [`from_stream`]: #method.from_stream
 pub struct Handle {
     document: Document,
+    display_list: RefCell<Option<DisplayList>>,
+    geometry_cache: RefCell<HashMap<GeometryCacheKey, (Rect, Rect)>>,
+    render_stats: Cell<RenderStats>,
 }
 
 impl Handle {
@@ -86,8 +190,117 @@ impl Handle {
         stream: &gio::InputStream,
         cancellable: Option<&gio::Cancellable>,
     ) -> Result<Handle, LoadingError> {
+        if load_options.cache_document {
+            return Handle::from_stream_shared(load_options, stream, cancellable);
+        }
+
         Ok(Handle {
             document: Document::load_from_stream(load_options, stream, cancellable)?,
+            display_list: RefCell::new(None),
+            geometry_cache: RefCell::new(HashMap::new()),
+            render_stats: Cell::new(RenderStats::default()),
+        })
+    }
+
+    /// Loads an SVG document, sharing the parsed form through [`DOCUMENT_CACHE`].
+    ///
+    /// The input has to be buffered completely so it can be content-hashed; this
+    /// is meant for icon-sized documents that get loaded over and over.
+    fn from_stream_shared(
+        load_options: &LoadOptions,
+        stream: &gio::InputStream,
+        cancellable: Option<&gio::Cancellable>,
+    ) -> Result<Handle, LoadingError> {
+        let mut content = Vec::new();
+
+        loop {
+            let bytes = stream.read_bytes(65536, cancellable)?;
+            if bytes.len() == 0 {
+                break;
+            }
+            content.extend_from_slice(&bytes);
+        }
+
+        let mut hasher = DefaultHasher::new();
+        content.hash(&mut hasher);
+        let key = (hasher.finish(), load_options.unlimited_size);
+
+        let cached = DOCUMENT_CACHE.lock().unwrap().get(&key).cloned();
+
+        if let Some(cached) = cached {
+            if cached.content == content {
+                match Handle::from_cache_data(load_options, &cached.cache_data) {
+                    Ok(handle) => return Ok(handle),
+                    Err(e) => {
+                        // Mismatched cache format version; re-parse below.
+                        rsvg_log!("could not load shared document cache entry ({})", e);
+                    }
+                }
+            }
+        }
+
+        let stream = gio::MemoryInputStream::new_from_bytes(&glib::Bytes::from(&content[..]));
+
+        let (handle, cache_data) =
+            Handle::from_stream_and_record(load_options, &stream.upcast(), cancellable)?;
+
+        let mut cache = DOCUMENT_CACHE.lock().unwrap();
+        if cache.len() >= DOCUMENT_CACHE_MAX_ENTRIES {
+            cache.clear();
+        }
+        cache.insert(
+            key,
+            Arc::new(CachedDocument {
+                content,
+                cache_data,
+            }),
+        );
+
+        Ok(handle)
+    }
+
+    /// Loads an SVG document into a `Handle`, and returns the document's serialized
+    /// pre-parsed event cache alongside it.
+    ///
+    /// The cache data can be saved to a file and later passed to [`from_cache_data`] to
+    /// load the same document without going through the XML parser.
+    ///
+    /// [`from_cache_data`]: #method.from_cache_data
+    pub fn from_stream_and_record(
+        load_options: &LoadOptions,
+        stream: &gio::InputStream,
+        cancellable: Option<&gio::Cancellable>,
+    ) -> Result<(Handle, Vec<u8>), LoadingError> {
+        let (document, cache_data) =
+            Document::load_from_stream_and_record(load_options, stream, cancellable)?;
+
+        Ok((
+            Handle {
+                document,
+                display_list: RefCell::new(None),
+                geometry_cache: RefCell::new(HashMap::new()),
+                render_stats: Cell::new(RenderStats::default()),
+            },
+            cache_data,
+        ))
+    }
+
+    /// Loads an SVG document from a pre-parsed event cache produced by
+    /// [`from_stream_and_record`].
+    ///
+    /// Fails if `data` is not a cache of the current format version; callers should
+    /// then fall back to parsing the original XML.
+    ///
+    /// [`from_stream_and_record`]: #method.from_stream_and_record
+    pub fn from_cache_data(
+        load_options: &LoadOptions,
+        data: &[u8],
+    ) -> Result<Handle, LoadingError> {
+        Ok(Handle {
+            document: Document::load_from_cache(load_options, data)?,
+            display_list: RefCell::new(None),
+            geometry_cache: RefCell::new(HashMap::new()),
+            render_stats: Cell::new(RenderStats::default()),
         })
     }
 
@@ -159,7 +372,18 @@ impl Handle {
             }
         }
 
-        self.get_node_geometry_with_viewport(&node, unit_rectangle(), dpi, is_testing)
+        let key = GeometryCacheKey::new(id, unit_rectangle(), dpi, is_testing);
+
+        if let Some(geometry) = self.geometry_cache.borrow().get(&key) {
+            return Ok(*geometry);
+        }
+
+        let geometry =
+            self.get_node_geometry_with_viewport(&node, unit_rectangle(), dpi, is_testing)?;
+
+        self.store_geometry(key, geometry);
+
+        Ok(geometry)
     }
 
     fn get_node_or_root(&self, id: Option<&str>) -> Result<Node, RenderingError> {
@@ -180,8 +404,20 @@ impl Handle {
         let node = self.get_node_or_root(id)?;
         let viewport = Rect::from(*viewport);
 
-        let (ink_rect, logical_rect) =
-            self.get_node_geometry_with_viewport(&node, viewport, dpi, is_testing)?;
+        let key = GeometryCacheKey::new(id, viewport, dpi, is_testing);
+
+        let cached = self.geometry_cache.borrow().get(&key).copied();
+
+        let (ink_rect, logical_rect) = match cached {
+            Some(geometry) => geometry,
+
+            None => {
+                let geometry =
+                    self.get_node_geometry_with_viewport(&node, viewport, dpi, is_testing)?;
+                self.store_geometry(key, geometry);
+                geometry
+            }
+        };
 
         Ok((
             cairo::Rectangle::from(ink_rect),
@@ -189,6 +425,14 @@ impl Handle {
         ))
     }
 
+    fn store_geometry(&self, key: GeometryCacheKey, geometry: (Rect, Rect)) {
+        let mut cache = self.geometry_cache.borrow_mut();
+        if cache.len() >= GEOMETRY_CACHE_MAX_ENTRIES {
+            cache.clear();
+        }
+        cache.insert(key, geometry);
+    }
+
     fn lookup_node(&self, id: &str) -> Result<Node, DefsLookupErrorKind> {
         match Href::parse(&id).map_err(DefsLookupErrorKind::HrefError)? {
             Href::PlainUrl(_) => Err(DefsLookupErrorKind::CannotLookupExternalReferences),
@@ -229,7 +473,103 @@ impl Handle {
         dpi: Dpi,
         is_testing: bool,
     ) -> Result<(), RenderingError> {
-        self.render_layer(cr, None, viewport, dpi, is_testing)
+        check_cairo_context(cr)?;
+
+        let rect = Rect::from(*viewport);
+
+        if let Some(ref display_list) = *self.display_list.borrow() {
+            if display_list.viewport == rect
+                && display_list.dpi == dpi
+                && display_list.is_testing == is_testing
+            {
+                return display_list.replay(cr);
+            }
+        }
+
+        // Record the render instead of drawing it directly on the caller's context.  This
+        // does change where filter effects get rasterized: they are resolved against this
+        // viewport and then transformed along with the replay, which is the usual tradeoff
+        // for retained rendering.
+        let surface = cairo::RecordingSurface::create(cairo::Content::ColorAlpha, None)
+            .map_err(RenderingError::Cairo)?;
+
+        {
+            let record_cr = cairo::Context::new(&surface);
+            self.render_layer(&record_cr, None, viewport, dpi, is_testing)?;
+        }
+
+        let display_list = DisplayList {
+            surface,
+            viewport: rect,
+            dpi,
+            is_testing,
+        };
+
+        let res = display_list.replay(cr);
+        *self.display_list.borrow_mut() = Some(display_list);
+        res
+    }
+
+    /// Renders the whole document one tile at a time.
+    ///
+    /// The viewport is split into a grid of `tile_size` × `tile_size` squares in the
+    /// target's user space; each tile is rendered into its own temporary image
+    /// surface with a translated transform and then composited onto `cr`.  Since the
+    /// scene gets recorded once by `render_document` and only replayed per tile,
+    /// cairo's working set stays tile-sized no matter how large the canvas is.
+    ///
+    /// A `tile_size` of zero renders everything in one pass, like `render_document`.
+    pub fn render_document_tiled(
+        &self,
+        cr: &cairo::Context,
+        viewport: &cairo::Rectangle,
+        tile_size: u32,
+        dpi: Dpi,
+        is_testing: bool,
+    ) -> Result<(), RenderingError> {
+        check_cairo_context(cr)?;
+
+        if tile_size == 0 {
+            return self.render_document(cr, viewport, dpi, is_testing);
+        }
+
+        let tile_size = f64::from(tile_size);
+
+        let mut y = viewport.y;
+        while y < viewport.y + viewport.height {
+            let tile_height = tile_size.min(viewport.y + viewport.height - y);
+
+            let mut x = viewport.x;
+            while x < viewport.x + viewport.width {
+                let tile_width = tile_size.min(viewport.x + viewport.width - x);
+
+                let surface = cairo::ImageSurface::create(
+                    cairo::Format::ARgb32,
+                    tile_width.ceil() as i32,
+                    tile_height.ceil() as i32,
+                )
+                .map_err(RenderingError::Cairo)?;
+
+                {
+                    let tile_cr = cairo::Context::new(&surface);
+                    tile_cr.translate(-x, -y);
+                    self.render_document(&tile_cr, viewport, dpi, is_testing)?;
+                }
+
+                cr.save();
+                cr.rectangle(x, y, tile_width, tile_height);
+                cr.clip();
+                cr.set_source_surface(&surface, x, y);
+                cr.paint();
+                cr.restore();
+
+                x += tile_size;
+            }
+
+            y += tile_size;
+        }
+
+        check_cairo_context(cr)
     }
 
     pub fn render_layer(
@@ -260,10 +600,13 @@ impl Handle {
             is_testing,
         );
 
+        let start = std::time::Instant::now();
+        let mut acquired_nodes = AcquiredNodes::new(&self.document);
+
         let res = draw_ctx
             .draw_node_from_stack(
                 &root,
-                &mut AcquiredNodes::new(&self.document),
+                &mut acquired_nodes,
                 &CascadedValues::new_from_node(&root),
                 false,
             )
@@ -271,6 +614,12 @@ impl Handle {
 
         cr.restore();
 
+        let elapsed = start.elapsed();
+        let mut stats = draw_ctx.stats();
+        stats.elements_referenced = acquired_nodes.num_elements_acquired();
+        stats.render_elapsed = elapsed.as_secs() as f64 + f64::from(elapsed.subsec_nanos()) / 1e9;
+        self.render_stats.set(stats);
+
         res
     }
 
@@ -353,10 +702,13 @@ impl Handle {
 
         let mut draw_ctx = DrawingCtx::new(None, &cr, unit_rectangle(), dpi, false, is_testing);
 
+        let start = std::time::Instant::now();
+        let mut acquired_nodes = AcquiredNodes::new(&self.document);
+
         let res = draw_ctx
             .draw_node_from_stack(
                 &node,
-                &mut AcquiredNodes::new(&self.document),
+                &mut acquired_nodes,
                 &CascadedValues::new_from_node(&node),
                 false,
             )
@@ -364,6 +716,12 @@ impl Handle {
 
         cr.restore();
 
+        let elapsed = start.elapsed();
+        let mut stats = draw_ctx.stats();
+        stats.elements_referenced = acquired_nodes.num_elements_acquired();
+        stats.render_elapsed = elapsed.as_secs() as f64 + f64::from(elapsed.subsec_nanos()) / 1e9;
+        self.render_stats.set(stats);
+
         res
     }
 
@@ -371,14 +729,62 @@ impl Handle {
         borrow_element_as!(self.document.root(), Svg).get_intrinsic_dimensions()
     }
 
+    /// Returns the counters accumulated by the most recent rendering pass.
+    ///
+    /// Replaying the retained display list does not re-render the scene, so
+    /// the stats keep describing the pass that recorded it.
+    pub fn render_stats(&self) -> RenderStats {
+        self.render_stats.get()
+    }
+
     pub fn set_stylesheet(&mut self, css: &str) -> Result<(), LoadingError> {
         let mut stylesheet = Stylesheet::new(Origin::User);
         stylesheet.parse(css, None)?;
         self.document.cascade(&[stylesheet]);
+
+        // The recorded draw commands and cached geometries embed the old
+        // cascade results.
+        *self.display_list.borrow_mut() = None;
+        self.geometry_cache.borrow_mut().clear();
+
         Ok(())
     }
 }
 
+/// Incremental loader for the legacy write/close API.
+///
+/// Chunks of bytes are fed straight into the XML parser as they arrive, so
+/// parsing overlaps with whatever I/O produces the bytes, and malformed
+/// documents are rejected before the whole payload has been transferred.
+/// Compressed data is not supported; callers must buffer those and use
+/// [`Handle::from_stream`] instead.
+///
+/// [`Handle::from_stream`]: struct.Handle.html#method.from_stream
+pub struct HandlePushParser {
+    parser: XmlPushParser,
+}
+
+impl HandlePushParser {
+    pub fn new(load_options: &LoadOptions) -> Result<HandlePushParser, LoadingError> {
+        Ok(HandlePushParser {
+            parser: Document::load_incrementally(load_options)?,
+        })
+    }
+
+    pub fn write(&self, buf: &[u8]) -> Result<(), LoadingError> {
+        self.parser.write(buf)
+    }
+
+    pub fn close(self) -> Result<Handle, LoadingError> {
+        Ok(Handle {
+            document: self.parser.close()?,
+            display_list: RefCell::new(None),
+            geometry_cache: RefCell::new(HashMap::new()),
+            render_stats: Cell::new(RenderStats::default()),
+        })
+    }
+}
+
 fn check_cairo_context(cr: &cairo::Context) -> Result<(), RenderingError> {
     let status = cr.status();
     if status == cairo::Status::Success {
@@ -1,11 +1,15 @@
 //! Utilities to acquire streams and data from from URLs.
 
+use std::ffi::CString;
+use std::ptr;
+
 use data_url;
 
 use gio::{
     BufferedInputStream, BufferedInputStreamExt, Cancellable, ConverterInputStream, File as GFile,
     FileExt, InputStream, MemoryInputStream, ZlibCompressorFormat, ZlibDecompressor,
 };
+use glib::translate::from_glib_full;
 use glib::{Bytes as GBytes, Cast};
 
 use crate::allowed_url::AllowedUrl;
@@ -70,6 +74,29 @@ pub fn get_input_stream_for_loading(
     }
 }
 
+/// Tries to memory-map a local file, returning its contents as `GBytes`.
+///
+/// The returned bytes reference the mapping directly, without copying the file
+/// contents; the underlying `GMappedFile` stays alive for as long as the bytes do.
+/// Returns `None` if the file is not local or cannot be mapped, in which case
+/// callers fall back to regular GIO reads.
+fn mmap_local_file(file: &GFile) -> Option<GBytes> {
+    let path = file.get_path()?;
+    let path = CString::new(path.to_str()?).ok()?;
+
+    unsafe {
+        let mapped = glib_sys::g_mapped_file_new(path.as_ptr(), glib_sys::GFALSE, ptr::null_mut());
+        if mapped.is_null() {
+            return None;
+        }
+
+        let bytes: GBytes = from_glib_full(glib_sys::g_mapped_file_get_bytes(mapped));
+        glib_sys::g_mapped_file_unref(mapped);
+
+        Some(bytes)
+    }
+}
+
 /// Returns an input stream.  The url can be a data: URL or a plain URI
 pub fn acquire_stream(
     aurl: &AllowedUrl,
@@ -92,6 +119,14 @@ pub fn acquire_stream(
         Ok(stream.upcast::<InputStream>())
     } else {
         let file = GFile::new_for_uri(uri);
+
+        // Map local files into memory instead of pulling them through a read loop;
+        // the MemoryInputStream references the mapping without copying it.
+        if let Some(bytes) = mmap_local_file(&file) {
+            let stream = MemoryInputStream::new_from_bytes(&bytes);
+            return Ok(stream.upcast::<InputStream>());
+        }
+
         let stream = file.read(cancellable)?;
 
         Ok(stream.upcast::<InputStream>())
@@ -109,6 +144,19 @@ pub fn acquire_data(
         Ok(decode_data_uri(uri)?)
     } else {
         let file = GFile::new_for_uri(uri);
+
+        // Map local files instead of reading them through GIO; this skips the
+        // chunked read loop and its reallocations.
+        if let Some(bytes) = mmap_local_file(&file) {
+            let (content_type, _uncertain) = gio::content_type_guess(Some(uri), &bytes);
+            let mime_type = gio::content_type_get_mime_type(&content_type).map(String::from);
+
+            return Ok(BinaryData {
+                data: bytes.to_vec(),
+                content_type: mime_type.map(From::from),
+            });
+        }
+
         let (contents, _etag) = file.load_contents(cancellable)?;
 
         let (content_type, _uncertain) = gio::content_type_guess(Some(uri), &contents);
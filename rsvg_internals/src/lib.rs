@@ -51,9 +51,11 @@ pub use crate::color::Color;
 
 pub use crate::dpi::Dpi;
 
+pub use crate::drawing_ctx::RenderStats;
+
 pub use crate::error::{DefsLookupErrorKind, HrefError, LoadingError, RenderingError};
 
-pub use crate::handle::{Handle, LoadOptions};
+pub use crate::handle::{Handle, HandlePushParser, LoadOptions};
 
 pub use crate::length::{Length, LengthUnit, RsvgLength};
 
@@ -94,7 +96,7 @@ mod aspect_ratio;
 mod bbox;
 mod color;
 mod cond;
-mod css;
+pub mod css;
 mod dasharray;
 mod document;
 mod dpi;
@@ -114,8 +116,8 @@ mod limits;
 mod marker;
 mod number_list;
 mod paint_server;
-mod path_builder;
-mod path_parser;
+pub mod path_builder;
+pub mod path_parser;
 mod pattern;
 mod properties;
 mod property_bag;
@@ -134,3 +136,4 @@ mod viewbox;
 mod xml;
 mod xml2;
 mod xml2_load;
+mod xml_cache;
@@ -1,5 +1,6 @@
 //! The `marker` element, and geometry computations for markers.
 
+use std::collections::HashMap;
 use std::f64::consts::*;
 use std::ops::Deref;
 
@@ -97,12 +98,70 @@ impl Default for Marker {
     }
 }
 
+/// Rasterized instance of a marker at a given orientation.
+///
+/// Along a single path, everything in the marker's transform except the
+/// per-vertex translation is constant, and translations of the group pattern
+/// reproduce a full render of the subtree.  GPS-trace documents put a
+/// `marker-mid` on polylines with tens of thousands of vertices; stamping the
+/// captured pattern per vertex avoids re-entering the whole drawing pipeline
+/// for each one.
+struct MarkerStamp {
+    pattern: cairo::Pattern,
+
+    /// User-space vertex position the pattern was captured at.
+    ref_x: f64,
+    ref_y: f64,
+
+    /// Bounding box of the reference render, relative to the path's transform.
+    local_transform: Transform,
+    rect: Option<Rect>,
+    ink_rect: Option<Rect>,
+}
+
+/// Cache of marker stamps for the duration of one path's marker pass.
+///
+/// Keyed by (marker reference, resolved rotation); markers with a fixed
+/// `orient` hit a single entry no matter how the path turns, while
+/// `orient="auto"` markers get one entry per distinct vertex angle.
+#[derive(Default)]
+struct MarkerStampCache(HashMap<(String, u64), MarkerStamp>);
+
+const MARKER_STAMP_CACHE_MAX_ENTRIES: usize = 64;
+
+impl MarkerStamp {
+    fn stamp(&self, draw_ctx: &mut DrawingCtx, xpos: f64, ypos: f64) -> BoundingBox {
+        let dx = xpos - self.ref_x;
+        let dy = ypos - self.ref_y;
+
+        let transform = draw_ctx
+            .get_transform()
+            .pre_translate(dx, dy)
+            .pre_transform(&self.local_transform);
+
+        let cr = draw_ctx.get_cairo_context();
+        cr.save();
+        cr.translate(dx, dy);
+        cr.set_source(&self.pattern);
+        cr.paint();
+        cr.restore();
+
+        BoundingBox {
+            transform,
+            rect: self.rect,
+            ink_rect: self.ink_rect,
+        }
+    }
+}
+
 impl Marker {
     fn render(
         &self,
         node: &Node,
         acquired_nodes: &mut AcquiredNodes,
         draw_ctx: &mut DrawingCtx,
+        name: &Fragment,
+        stamps: &mut MarkerStampCache,
         xpos: f64,
         ypos: f64,
         computed_angle: Angle,
@@ -128,6 +187,17 @@ impl Marker {
             MarkerOrient::Angle(a) => a,
         };
 
+        // When not clipping, instance the marker: vertices that only differ by
+        // their translation reuse the rasterization captured at the first one.
+        // Clip paths need the real geometry, so they always render in full.
+        let key = (name.to_string(), rotation.radians().to_bits());
+
+        if !clipping {
+            if let Some(stamp) = stamps.0.get(&key) {
+                return Ok(stamp.stamp(draw_ctx, xpos, ypos));
+            }
+        }
+
         let mut transform = Transform::new_translate(xpos, ypos).pre_rotate(rotation);
 
         if self.units == MarkerUnits::StrokeWidth {
@@ -165,13 +235,53 @@ impl Marker {
             )
         };
 
-        draw_ctx.with_saved_transform(Some(transform), &mut |dc| {
+        let cr = draw_ctx.get_cairo_context();
+
+        if !clipping {
+            // Capture the render into a group so it can be stamped at
+            // subsequent vertices; painting the group back here reproduces a
+            // direct render exactly.
+            cr.push_group();
+        }
+
+        let res = draw_ctx.with_saved_transform(Some(transform), &mut |dc| {
             dc.with_clip_rect(clip, &mut |dc| {
                 dc.with_discrete_layer(node, acquired_nodes, values, clipping, &mut |an, dc| {
                     node.draw_children(an, &cascaded, dc, clipping)
                 })
             })
-        })
+        });
+
+        if !clipping {
+            let pattern = cr.pop_group();
+
+            let bbox = res?;
+
+            cr.save();
+            cr.set_source(&pattern);
+            cr.paint();
+            cr.restore();
+
+            if stamps.0.len() < MARKER_STAMP_CACHE_MAX_ENTRIES {
+                if let Some(inverse) = draw_ctx.get_transform().invert() {
+                    stamps.0.insert(
+                        key,
+                        MarkerStamp {
+                            pattern,
+                            ref_x: xpos,
+                            ref_y: ypos,
+                            local_transform: inverse.pre_transform(&bbox.transform),
+                            rect: bbox.rect,
+                            ink_rect: bbox.ink_rect,
+                        },
+                    );
+                }
+            }
+
+            Ok(bbox)
+        } else {
+            res
+        }
     }
 }
 
@@ -558,6 +668,7 @@ fn emit_marker_by_name(
     draw_ctx: &mut DrawingCtx,
     acquired_nodes: &mut AcquiredNodes,
     name: &Fragment,
+    stamps: &mut MarkerStampCache,
     xpos: f64,
     ypos: f64,
     computed_angle: Angle,
@@ -572,6 +683,8 @@ fn emit_marker_by_name(
                 &node,
                 acquired_nodes,
                 draw_ctx,
+                name,
+                stamps,
                 xpos,
                 ypos,
                 computed_angle,
@@ -641,6 +754,8 @@ pub fn render_markers_for_path(
         return Ok(draw_ctx.empty_bbox());
     }
 
+    let mut stamps = MarkerStampCache::default();
+
     emit_markers_for_path(
         path,
         draw_ctx.empty_bbox(),
@@ -654,6 +769,7 @@ pub fn render_markers_for_path(
                     draw_ctx,
                     acquired_nodes,
                     marker,
+                    &mut stamps,
                     x,
                     y,
                     computed_angle,
@@ -14,13 +14,14 @@
 use markup5ever::QualName;
 use std::cell::{Ref, RefMut};
 use std::fmt;
+use std::rc::Rc;
 
 use crate::bbox::BoundingBox;
 use crate::document::AcquiredNodes;
 use crate::drawing_ctx::DrawingCtx;
 use crate::element::*;
 use crate::error::*;
-use crate::properties::ComputedValues;
+use crate::properties::{ComputedValues, StyleSharingCache};
 use crate::property_bag::PropertyBag;
 use crate::text::Chars;
 
@@ -249,22 +250,21 @@ macro_rules! borrow_element_as {
 
 /// Helper trait for cascading recursively
 pub trait NodeCascade {
-    fn cascade(&mut self, values: &ComputedValues);
+    fn cascade(&mut self, values: &Rc<ComputedValues>, cache: &mut StyleSharingCache);
 }
 
 impl NodeCascade for Node {
-    fn cascade(&mut self, values: &ComputedValues) {
-        let mut values = values.clone();
-
-        {
+    fn cascade(&mut self, values: &Rc<ComputedValues>, cache: &mut StyleSharingCache) {
+        let values = {
             let mut elt = self.borrow_element_mut();
 
-            elt.get_specified_values().to_computed_values(&mut values);
+            let values = cache.compute(elt.get_specified_values(), values);
             elt.set_computed_values(&values);
-        }
+            values
+        };
 
         for mut child in self.children().filter(|c| c.is_element()) {
-            child.cascade(&values);
+            child.cascade(&values, cache);
         }
     }
 }
@@ -2,8 +2,13 @@
 
 use tinyvec::TinyVec;
 
+use std::cell::RefCell;
+use std::collections::hash_map::DefaultHasher;
+use std::collections::HashMap;
 use std::f64;
 use std::f64::consts::*;
+use std::hash::Hasher;
+use std::rc::{Rc, Weak};
 use std::slice;
 
 use crate::float_eq_cairo::ApproxEqCairo;
@@ -460,7 +465,7 @@ pub struct Path {
 
 /// Packed version of a `PathCommand`, used in `Path`.
 #[repr(u8)]
-#[derive(Debug, Clone, Copy)]
+#[derive(Debug, Clone, Copy, PartialEq)]
 enum PackedCommand {
     MoveTo,
     LineTo,
@@ -499,6 +504,41 @@ impl PathBuilder {
         }
     }
 
+    /// Like `into_path`, but interns the result.
+    ///
+    /// Documents with fonts converted to outlines, or with tool-generated geometry,
+    /// contain thousands of `<path>` elements whose `d` attributes are exact
+    /// duplicates of each other.  Paths built through this function are looked up in
+    /// a per-thread intern table by content hash, so identical geometry ends up
+    /// sharing a single allocation.
+    ///
+    /// The table holds weak references; it does not keep paths alive once their last
+    /// user is gone.
+    pub fn into_path_interned(self) -> Rc<Path> {
+        let path = self.into_path();
+        let hash = path.content_hash();
+
+        INTERNED_PATHS.with(|interned| {
+            let mut interned = interned.borrow_mut();
+            let bucket = interned.entry(hash).or_insert_with(Vec::new);
+
+            // Drop entries for paths that are already gone.
+            bucket.retain(|weak| weak.strong_count() > 0);
+
+            for weak in bucket.iter() {
+                if let Some(existing) = weak.upgrade() {
+                    if existing.content_eq(&path) {
+                        return existing;
+                    }
+                }
+            }
+
+            let path = Rc::new(path);
+            bucket.push(Rc::downgrade(&path));
+            path
+        })
+    }
+
     pub fn move_to(&mut self, x: f64, y: f64) {
         self.path_commands.push(PathCommand::MoveTo(x, y));
     }
@@ -544,7 +584,40 @@ impl PathBuilder {
     }
 }
 
+thread_local! {
+    /// Intern table for `PathBuilder::into_path_interned`, keyed by content hash.
+    /// Hash collisions go in the same bucket and are resolved with `content_eq`.
+    static INTERNED_PATHS: RefCell<HashMap<u64, Vec<Weak<Path>>>> = RefCell::new(HashMap::new());
+}
+
 impl Path {
+    /// Hashes the packed commands and the bit representation of the coordinates.
+    fn content_hash(&self) -> u64 {
+        let mut hasher = DefaultHasher::new();
+
+        for &cmd in self.commands.iter() {
+            hasher.write_u8(cmd as u8);
+        }
+
+        for &coord in self.coords.iter() {
+            hasher.write_u64(coord.to_bits());
+        }
+
+        hasher.finish()
+    }
+
+    /// Compares paths by content; coordinates compare by bit representation so that
+    /// this stays consistent with `content_hash` even for NaNs.
+    fn content_eq(&self, other: &Path) -> bool {
+        self.commands == other.commands
+            && self.coords.len() == other.coords.len()
+            && self
+                .coords
+                .iter()
+                .zip(other.coords.iter())
+                .all(|(a, b)| a.to_bits() == b.to_bits())
+    }
+
     pub fn iter<'a>(&'a self) -> impl Iterator<Item = PathCommand> + 'a {
         let commands = self.commands.iter();
         let mut coords = self.coords.iter();
@@ -601,6 +674,26 @@ mod tests {
         assert_eq!(path.iter().count(), 0);
     }
 
+    #[test]
+    fn interning_shares_identical_paths() {
+        let build = || {
+            let mut builder = PathBuilder::new();
+            builder.move_to(42.0, 43.0);
+            builder.line_to(44.0, 45.0);
+            builder.close_path();
+            builder
+        };
+
+        let first = build().into_path_interned();
+        let second = build().into_path_interned();
+        assert!(Rc::ptr_eq(&first, &second));
+
+        let mut builder = PathBuilder::new();
+        builder.move_to(42.0, 43.0);
+        let different = builder.into_path_interned();
+        assert!(!Rc::ptr_eq(&first, &different));
+    }
+
     #[test]
     fn all_commands() {
         let mut builder = PathBuilder::new();
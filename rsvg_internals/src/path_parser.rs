@@ -2,14 +2,14 @@
 
 use std::error::Error;
 use std::fmt;
-use std::iter::Enumerate;
 use std::str;
-use std::str::Chars;
 
 use crate::path_builder::*;
 
 struct PathParser<'b> {
-    chars_enumerator: Enumerate<Chars<'b>>,
+    path_str: &'b str,
+    next_pos: usize,            // byte index just past the lookahead character
+    chars_read: usize,          // number of characters read so far, including the lookahead
     lookahead: Option<char>,    // None if we are in EOF
     current_pos: Option<usize>, // None if the string hasn't been scanned
 
@@ -61,7 +61,9 @@ struct PathParser<'b> {
 impl<'b> PathParser<'b> {
     fn new(builder: &'b mut PathBuilder, path_str: &'b str) -> PathParser<'b> {
         PathParser {
-            chars_enumerator: path_str.chars().enumerate(),
+            path_str,
+            next_pos: 0,
+            chars_read: 0,
             lookahead: None,
             current_pos: None,
 
@@ -89,18 +91,31 @@ impl<'b> PathParser<'b> {
     }
 
     fn getchar(&mut self) {
-        if let Some((pos, c)) = self.chars_enumerator.next() {
+        let bytes = self.path_str.as_bytes();
+
+        if self.next_pos < bytes.len() {
+            // Path data is almost always plain ASCII; pick single bytes off the
+            // slice directly and only fall back to full UTF-8 decoding for the
+            // rare non-ASCII character.
+            let b = bytes[self.next_pos];
+
+            let c = if b < 0x80 {
+                self.next_pos += 1;
+                b as char
+            } else {
+                let c = self.path_str[self.next_pos..].chars().next().unwrap();
+                self.next_pos += c.len_utf8();
+                c
+            };
+
             self.lookahead = Some(c);
-            self.current_pos = Some(pos);
+            self.current_pos = Some(self.chars_read);
+            self.chars_read += 1;
         } else {
             // We got to EOF; make current_pos point to the position after the last char in the
             // string
             self.lookahead = None;
-            if self.current_pos.is_none() {
-                self.current_pos = Some(0);
-            } else {
-                self.current_pos = Some(self.current_pos.unwrap() + 1);
-            }
+            self.current_pos = Some(self.chars_read);
         }
     }
 
@@ -123,19 +138,24 @@ impl<'b> PathParser<'b> {
     }
 
     fn whitespace(&mut self) -> Result<(), ParseError> {
-        if let Some(c) = self.lookahead {
-            if c.is_whitespace() {
-                assert!(self.match_char(c));
-
-                while let Some(c) = self.lookahead {
-                    if c.is_whitespace() {
-                        assert!(self.match_char(c));
-                        continue;
-                    } else {
-                        break;
-                    }
-                }
+        while let Some(c) = self.lookahead {
+            if !c.is_whitespace() {
+                break;
+            }
+
+            // The lookahead is whitespace; skip the rest of the run directly over
+            // the byte slice.  This covers the ASCII whitespace that actually
+            // occurs in path data; anything else goes around the loop again.
+            let bytes = self.path_str.as_bytes();
+
+            let mut end = self.next_pos;
+            while end < bytes.len() && matches!(bytes[end], b' ' | b'\x09'..=b'\x0d') {
+                end += 1;
             }
+
+            self.chars_read += end - self.next_pos;
+            self.next_pos = end;
+            self.getchar();
         }
 
         Ok(())
@@ -184,6 +204,33 @@ impl<'b> PathParser<'b> {
             || self.lookahead_is('-')
     }
 
+    /// Consumes the run of ASCII digits that starts at the current lookahead
+    /// character, if any, and returns it as a byte slice.
+    ///
+    /// This scans the underlying bytes directly instead of going through the
+    /// per-character machinery; digit runs make up the bulk of path data.
+    fn digit_run(&mut self) -> &'b [u8] {
+        match self.lookahead {
+            Some(c) if c.is_digit(10) => (),
+            _ => return &[],
+        }
+
+        let bytes: &'b [u8] = self.path_str.as_bytes();
+
+        let start = self.next_pos - 1; // the lookahead digit is a single byte
+        let mut end = self.next_pos;
+        while end < bytes.len() && bytes[end].is_ascii_digit() {
+            end += 1;
+        }
+
+        // The lookahead digit was already counted by getchar().
+        self.chars_read += end - self.next_pos;
+        self.next_pos = end;
+        self.getchar();
+
+        &bytes[start..end]
+    }
+
     fn number(&mut self) -> Result<f64, ParseError> {
         let mut sign: f64;
 
@@ -195,7 +242,6 @@ impl<'b> PathParser<'b> {
             sign = -1.0;
         }
 
-        let mut has_integer_part = false;
         let mut value: f64;
         let mut exponent_sign: f64;
         let mut exponent: Option<f64>;
@@ -208,28 +254,26 @@ impl<'b> PathParser<'b> {
 
         if self.lookahead_is_digit(&mut c) || self.lookahead_is('.') {
             // Integer part
-            while self.lookahead_is_digit(&mut c) {
-                has_integer_part = true;
-                value = value * 10.0 + f64::from(char_to_digit(c));
+            let int_digits = self.digit_run();
+            let has_integer_part = !int_digits.is_empty();
 
-                assert!(self.match_char(c));
+            for &b in int_digits {
+                value = value * 10.0 + f64::from(b - b'0');
             }
 
             // Fractional part
             if self.match_char('.') {
-                let mut fraction: f64 = 1.0;
-
-                let mut c: char = ' ';
+                let frac_digits = self.digit_run();
 
-                if !has_integer_part && !self.lookahead_is_digit(&mut c) {
+                if !has_integer_part && frac_digits.is_empty() {
                     return Err(self.error(ErrorKind::UnexpectedToken));
                 }
 
-                while self.lookahead_is_digit(&mut c) {
-                    fraction /= 10.0;
-                    value += fraction * f64::from(char_to_digit(c));
+                let mut fraction: f64 = 1.0;
 
-                    assert!(self.match_char(c));
+                for &b in frac_digits {
+                    fraction /= 10.0;
+                    value += fraction * f64::from(b - b'0');
                 }
             }
 
@@ -242,15 +286,13 @@ impl<'b> PathParser<'b> {
                 }
 
                 // exponent
-                let mut c: char = ' ';
+                let exp_digits = self.digit_run();
 
-                if self.lookahead_is_digit(&mut c) {
+                if !exp_digits.is_empty() {
                     let mut exp = 0.0;
 
-                    while self.lookahead_is_digit(&mut c) {
-                        exp = exp * 10.0 + f64::from(char_to_digit(c));
-
-                        assert!(self.match_char(c));
+                    for &b in exp_digits {
+                        exp = exp * 10.0 + f64::from(b - b'0');
                     }
 
                     exponent = Some(exp);
@@ -896,10 +938,6 @@ impl<'b> PathParser<'b> {
     }
 }
 
-fn char_to_digit(c: char) -> i32 {
-    c as i32 - '0' as i32
-}
-
 #[derive(Debug, PartialEq)]
 pub enum ErrorKind {
     UnexpectedToken,
@@ -3,6 +3,7 @@
 use markup5ever::{expanded_name, local_name, namespace_url, ns};
 use std::cell::RefCell;
 use std::f64;
+use std::rc::Rc;
 
 use crate::allowed_url::Fragment;
 use crate::aspect_ratio::*;
@@ -109,6 +110,25 @@ pub struct ResolvedPattern {
 
     // Link to the node whose children are the pattern's resolved children.
     children: Children,
+
+    // Cached rasterized tile, shared between clones of this resolved pattern
+    // so it lives as long as the pattern node itself.  See TileKey.
+    tile: Rc<RefCell<Option<(TileKey, cairo::Surface)>>>,
+}
+
+/// Parameters under which a pattern tile was rasterized.
+///
+/// Pattern contents are invariant for a loaded document, so a tile rendered at
+/// a given device size, contents transform, and opacity can be reused by every
+/// subsequent fill that would rasterize it identically.  Cartographic documents
+/// fill thousands of shapes with the same few hatch patterns; with this key the
+/// content subtree is drawn once per distinct scale instead of once per fill.
+#[derive(PartialEq)]
+struct TileKey {
+    width: i32,
+    height: i32,
+    caffine: Transform,
+    opacity: f64,
 }
 
 #[derive(Default)]
@@ -334,36 +354,61 @@ impl AsPaintSource for ResolvedPattern {
             affine = affine.pre_scale(1.0 / scwscale, 1.0 / schscale);
         }
 
-        // Draw to another surface
-
         let cr_save = draw_ctx.get_cairo_context();
 
-        let surface = cr_save
-            .get_target()
-            .create_similar(cairo::Content::ColorAlpha, pw, ph)?;
+        let key = TileKey {
+            width: pw,
+            height: ph,
+            caffine,
+            opacity: opacity.0,
+        };
+
+        let cached = self
+            .tile
+            .borrow()
+            .as_ref()
+            .and_then(|(k, s)| if *k == key { Some(s.clone()) } else { None });
 
-        let cr_pattern = cairo::Context::new(&surface);
+        let surface = match cached {
+            Some(surface) => surface,
 
-        draw_ctx.set_cairo_context(&cr_pattern);
+            None => {
+                // Draw to another surface
 
-        // Set up transformations to be determined by the contents units
-        cr_pattern.set_matrix(caffine.into());
+                let surface = cr_save
+                    .get_target()
+                    .create_similar(cairo::Content::ColorAlpha, pw, ph)?;
 
-        // Draw everything
-        let res = draw_ctx.with_alpha(opacity, &mut |dc| {
-            let pattern_cascaded = CascadedValues::new_from_node(&node);
-            let pattern_values = pattern_cascaded.get();
-            dc.with_discrete_layer(
-                &node,
-                acquired_nodes,
-                pattern_values,
-                false,
-                &mut |an, dc| node.draw_children(an, &pattern_cascaded, dc, false),
-            )
-        });
+                let cr_pattern = cairo::Context::new(&surface);
 
-        // Return to the original coordinate system and rendering context
-        draw_ctx.set_cairo_context(&cr_save);
+                draw_ctx.set_cairo_context(&cr_pattern);
+
+                // Set up transformations to be determined by the contents units
+                cr_pattern.set_matrix(caffine.into());
+
+                // Draw everything
+                let res = draw_ctx.with_alpha(opacity, &mut |dc| {
+                    let pattern_cascaded = CascadedValues::new_from_node(&node);
+                    let pattern_values = pattern_cascaded.get();
+                    dc.with_discrete_layer(
+                        &node,
+                        acquired_nodes,
+                        pattern_values,
+                        false,
+                        &mut |an, dc| node.draw_children(an, &pattern_cascaded, dc, false),
+                    )
+                });
+
+                // Return to the original coordinate system and rendering context
+                draw_ctx.set_cairo_context(&cr_save);
+
+                res?;
+
+                self.tile.replace(Some((key, surface.clone())));
+
+                surface
+            }
+        };
 
         // Set the final surface as a Cairo pattern into the Cairo context
         let pattern = cairo::SurfacePattern::create(&surface);
@@ -373,7 +418,7 @@ impl AsPaintSource for ResolvedPattern {
         pattern.set_filter(cairo::Filter::Best);
         cr_save.set_source(&pattern);
 
-        res.and_then(|_| Ok(true))
+        Ok(true)
     }
 }
 
@@ -393,6 +438,8 @@ impl UnresolvedPattern {
             height: self.common.height.unwrap(),
 
             children: self.children.to_resolved(),
+
+            tile: Rc::new(RefCell::new(None)),
         }
     }
 
@@ -3,8 +3,10 @@
 use cssparser::{
     self, BasicParseErrorKind, DeclarationListParser, ParseErrorKind, Parser, ParserInput, ToCss,
 };
-use markup5ever::{expanded_name, local_name, namespace_url, ns, QualName};
-use std::collections::HashSet;
+use markup5ever::{expanded_name, local_name, namespace_url, ns, LocalName, QualName};
+use once_cell::sync::Lazy;
+use std::collections::{HashMap, HashSet};
+use std::rc::Rc;
 
 use crate::css::{DeclParser, Declaration, Origin};
 use crate::error::*;
@@ -23,7 +25,7 @@ use crate::property_macros::Property;
 ///
 /// `Specified` is a value given by the SVG or CSS stylesheet.  This will later be
 /// resolved into part of a `ComputedValues` struct.
-#[derive(Clone)]
+#[derive(Clone, PartialEq)]
 pub enum SpecifiedValue<T>
 where
     T: Property<ComputedValues> + Clone + Default,
@@ -67,7 +69,7 @@ impl PropertyId {
 }
 
 /// Holds the specified CSS properties for an element
-#[derive(Clone)]
+#[derive(Clone, PartialEq)]
 pub struct SpecifiedValues {
     indices: [u8; PropertyId::UnsetProperty as usize],
     props: Vec<ParsedProperty>,
@@ -154,7 +156,7 @@ macro_rules! make_properties {
         }
 
         /// Embodies "which property is this" plus the property's value
-        #[derive(Clone)]
+        #[derive(Clone, PartialEq)]
         pub enum ParsedProperty {
             // we put all the properties here; these are for SpecifiedValues
             $($short_name(SpecifiedValue<$short_name>),)+
@@ -250,32 +252,56 @@ macro_rules! make_properties {
             }
         }
 
+        /// Maps the interned name of each property to its `PropertyId`.
+        ///
+        /// Property names come in as `LocalName` interned atoms, so looking one up
+        /// here hashes a single integer instead of comparing the name against every
+        /// known property in turn.
+        static PROPERTY_IDS: Lazy<HashMap<LocalName, PropertyId>> = Lazy::new(|| {
+            let mut ids = HashMap::new();
+
+            $(ids.insert(local_name!($long_str), PropertyId::$long_name);)+
+            $(ids.insert(local_name!($short_str), PropertyId::$short_name);)+
+
+            ids
+        });
+
         pub fn parse_property<'i>(
             prop_name: &QualName,
             input: &mut Parser<'i, '_>,
             accept_shorthands: bool
         ) -> Result<ParsedProperty, ParseError<'i>> {
-            match prop_name.expanded() {
+            let unknown_property = |input: &mut Parser<'i, '_>| {
+                let loc = input.current_source_location();
+                Err(loc.new_custom_error(ValueErrorKind::UnknownProperty))
+            };
+
+            if prop_name.ns != ns!() {
+                return unknown_property(input);
+            }
+
+            let id = match PROPERTY_IDS.get(&prop_name.local) {
+                Some(&id) => id,
+                None => return unknown_property(input),
+            };
+
+            match id {
                 $(
-                    expanded_name!("", $long_str) =>
+                    PropertyId::$long_name =>
                         Ok(ParsedProperty::$long_name(parse_input(input)?)),
                 )+
 
                 $(
-                    expanded_name!("", $short_str) => {
+                    PropertyId::$short_name => {
                         if accept_shorthands {
                             Ok(ParsedProperty::$short_name(parse_input(input)?))
                         } else {
-                            let loc = input.current_source_location();
-                            Err(loc.new_custom_error(ValueErrorKind::UnknownProperty))
+                            unknown_property(input)
                         }
                     }
                 )+
 
-                _ => {
-                    let loc = input.current_source_location();
-                    Err(loc.new_custom_error(ValueErrorKind::UnknownProperty))
-                }
+                _ => unknown_property(input),
             }
         }
     };
@@ -650,6 +676,87 @@ impl SpecifiedValues {
     }
 }
 
+/// Style-sharing cache used during the cascade.
+///
+/// Real-world documents frequently contain long runs of sibling elements with
+/// identical specified values — think of the thousands of `<path>` elements that a
+/// vector editor emits with the same `fill` and `stroke`.  Computing each of their
+/// styles independently would produce that many identical `ComputedValues` structs.
+///
+/// This cache remembers recently computed styles keyed by (parent computed style,
+/// specified values); when an element matches an entry, it gets a reference-counted
+/// clone of the already-computed style instead of a freshly computed copy.  Parent
+/// styles are compared by `Rc` pointer identity, which is exact since siblings share
+/// the very same parent style.
+pub struct StyleSharingCache {
+    entries: Vec<CacheEntry>,
+}
+
+struct CacheEntry {
+    parent: Rc<ComputedValues>,
+    specified: SpecifiedValues,
+    computed: Rc<ComputedValues>,
+}
+
+impl StyleSharingCache {
+    /// Identically-styled elements tend to appear in runs, so a small cache already
+    /// gets most of the sharing; this also bounds the cost of the linear lookup.
+    const MAX_ENTRIES: usize = 32;
+
+    pub fn new() -> StyleSharingCache {
+        StyleSharingCache {
+            entries: Vec::with_capacity(Self::MAX_ENTRIES),
+        }
+    }
+
+    /// Computes the style for `specified` as cascaded from the `parent` style.
+    ///
+    /// Returns a shared `ComputedValues` if an identically-styled element was seen
+    /// recently; otherwise computes the style and caches it.
+    pub fn compute(
+        &mut self,
+        specified: &SpecifiedValues,
+        parent: &Rc<ComputedValues>,
+    ) -> Rc<ComputedValues> {
+        if let Some(pos) = self
+            .entries
+            .iter()
+            .position(|e| Rc::ptr_eq(&e.parent, parent) && e.specified == *specified)
+        {
+            // Move the entry to the front so frequently-shared styles stay cached.
+            let entry = self.entries.remove(pos);
+            let computed = entry.computed.clone();
+            self.entries.insert(0, entry);
+            return computed;
+        }
+
+        let mut computed = (**parent).clone();
+        specified.to_computed_values(&mut computed);
+        let computed = Rc::new(computed);
+
+        if self.entries.len() == Self::MAX_ENTRIES {
+            self.entries.pop();
+        }
+
+        self.entries.insert(
+            0,
+            CacheEntry {
+                parent: parent.clone(),
+                specified: specified.clone(),
+                computed: computed.clone(),
+            },
+        );
+
+        computed
+    }
+}
+
+impl Default for StyleSharingCache {
+    fn default() -> StyleSharingCache {
+        StyleSharingCache::new()
+    }
+}
+
 // Parses the value for the type `T` of the property out of the Parser, including `inherit` values.
 fn parse_input<'i, T>(input: &mut Parser<'i, '_>) -> Result<SpecifiedValue<T>, ParseError<'i>>
 where
@@ -696,6 +803,30 @@ mod tests {
         assert_eq!(computed.stroke_width(), StrokeWidth(length));
     }
 
+    #[test]
+    fn style_sharing_cache_shares_identical_styles() {
+        let length = Length::<Both>::new(42.0, LengthUnit::Px);
+
+        let mut specified = SpecifiedValues::default();
+        specified.set_parsed_property(&ParsedProperty::StrokeWidth(SpecifiedValue::Specified(
+            StrokeWidth(length),
+        )));
+
+        let parent = Rc::new(ComputedValues::default());
+
+        let mut cache = StyleSharingCache::new();
+        let first = cache.compute(&specified, &parent);
+        let second = cache.compute(&specified, &parent);
+
+        assert!(Rc::ptr_eq(&first, &second));
+        assert_eq!(first.stroke_width(), StrokeWidth(length));
+
+        // A different parent style must not share, even with equal specified values.
+        let other_parent = Rc::new(ComputedValues::default());
+        let third = cache.compute(&specified, &other_parent);
+        assert!(!Rc::ptr_eq(&first, &third));
+    }
+
     #[test]
     fn replace_existing_property() {
         let length1 = Length::<Both>::new(42.0, LengthUnit::Px);
@@ -43,7 +43,7 @@ impl<'a> PropertyBag<'a> {
         n_attributes: usize,
         attrs: *const *const libc::c_char,
     ) -> PropertyBag<'a> {
-        let mut array = Vec::new();
+        let mut array = Vec::with_capacity(n_attributes);
 
         if n_attributes > 0 && !attrs.is_null() {
             for attr in slice::from_raw_parts(attrs, n_attributes * 5).chunks_exact(5) {
@@ -86,6 +86,14 @@ impl<'a> PropertyBag<'a> {
         PropertyBag(array)
     }
 
+    /// Creates an iterable `PropertyBag` from already-parsed attribute/value pairs.
+    ///
+    /// This is used when replaying a pre-parsed XML event cache, where the attribute
+    /// names and values no longer come from libxml2's arrays.
+    pub fn new_from_pairs(pairs: &[(QualName, &'a str)]) -> PropertyBag<'a> {
+        PropertyBag(pairs.to_vec())
+    }
+
     /// Returns the number of attributes in the property bag.
     pub fn len(&self) -> usize {
         self.0.len()
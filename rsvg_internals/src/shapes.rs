@@ -126,7 +126,7 @@ impl SetAttributes for Path {
 
                     rsvg_log!("could not parse path: {}", e);
                 }
-                self.path = Some(Rc::new(builder.into_path()));
+                self.path = Some(builder.into_path_interned());
             }
         }
 
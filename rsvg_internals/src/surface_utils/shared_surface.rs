@@ -1,10 +1,12 @@
 //! Shared access to Cairo image surfaces.
+use std::cell::RefCell;
 use std::cmp::min;
 use std::marker::PhantomData;
 use std::ptr::NonNull;
 
 use gdk_pixbuf::{Colorspace, Pixbuf};
 use nalgebra::{storage::Storage, Dim, Matrix};
+use rayon::prelude::*;
 
 use crate::rect::{IRect, Rect};
 use crate::surface_utils::srgb;
@@ -49,6 +51,76 @@ impl SurfaceType {
     }
 }
 
+thread_local! {
+    /// Per-thread pool of idle ARGB32 surfaces available for reuse.
+    ///
+    /// The filter pipeline allocates a full-size intermediate surface per primitive, per
+    /// render; embedders that re-render every frame turn that into a large amount of
+    /// allocator traffic for identically-sized buffers.  Surfaces in this pool are held
+    /// exclusively (their Cairo reference count is 1), so handing one out preserves the
+    /// uniqueness invariants of `ImageSurface`.  Surfaces come back through
+    /// `SharedImageSurface::recycle()`, which only pools a surface if it holds the last
+    /// reference to it.
+    static SURFACE_POOL: RefCell<Vec<cairo::ImageSurface>> = RefCell::new(Vec::new());
+}
+
+/// Maximum number of surfaces retained in the per-thread pool.
+const SURFACE_POOL_MAX_SURFACES: usize = 8;
+
+/// Creates an ARGB32 image surface, reusing an idle same-size one from the pool if possible.
+fn create_argb32_surface(width: i32, height: i32) -> Result<cairo::ImageSurface, cairo::Status> {
+    let recycled = SURFACE_POOL.with(|pool| {
+        let mut pool = pool.borrow_mut();
+
+        pool.iter()
+            .position(|s| s.get_width() == width && s.get_height() == height)
+            .map(|i| pool.remove(i))
+    });
+
+    if let Some(mut surface) = recycled {
+        // Clear the recycled surface back to transparent black; callers rely on newly
+        // created surfaces being fully cleared.  Failure to borrow the data shouldn't
+        // happen for an idle surface, but if it does, just fall through to a fresh
+        // allocation.
+        let cleared = match surface.get_data() {
+            Ok(mut data) => {
+                for byte in data.iter_mut() {
+                    *byte = 0;
+                }
+
+                true
+            }
+            Err(_) => false,
+        };
+
+        if cleared {
+            return Ok(surface);
+        }
+    }
+
+    cairo::ImageSurface::create(cairo::Format::ARgb32, width, height)
+}
+
+/// Returns `surface` to the pool if it isn't referenced from anywhere else.
+fn return_to_pool(surface: cairo::ImageSurface) {
+    let reference_count =
+        unsafe { cairo_sys::cairo_surface_get_reference_count(surface.to_raw_none()) };
+
+    if reference_count != 1 || surface.get_width() <= 0 || surface.get_height() <= 0 {
+        return;
+    }
+
+    SURFACE_POOL.with(|pool| {
+        let mut pool = pool.borrow_mut();
+
+        if pool.len() >= SURFACE_POOL_MAX_SURFACES {
+            pool.remove(0);
+        }
+
+        pool.push(surface);
+    });
+}
+
 /// Wrapper for a Cairo image surface that enforces exclusive access when modifying it.
 ///
 /// Shared access to `cairo::ImageSurface` is tricky since a read-only borrowed reference
@@ -125,6 +197,125 @@ impl IsAlphaOnly for NotAlphaOnly {
     const IS_ALPHA_ONLY: bool = false;
 }
 
+// The following struct is needed for the parallel implementations of the blur loops. The
+// blurring is done either for each row or for each column of pixels, depending on the
+// blur direction, independently of the others. Naturally, we want to run the outer loop
+// on a thread pool.
+//
+// The horizontal case is simple since the input image slice can be partitioned into
+// chunks for each row of pixels and processed in parallel with rayon. The vertical case,
+// however, is more involved because we can't just make mutable slices for all pixel
+// columns (they would be overlapping which is forbidden by the aliasing rules).
+//
+// This is where the following struct comes into play: it stores a sub-slice of the
+// pixel data and can be split at any row or column into two parts (similar to
+// slice::split_at_mut()).
+struct UnsafeSendPixelData<'a> {
+    width: u32,
+    height: u32,
+    stride: isize,
+    ptr: NonNull<u8>,
+    _marker: PhantomData<&'a mut ()>,
+}
+
+unsafe impl<'a> Send for UnsafeSendPixelData<'a> {}
+
+impl<'a> UnsafeSendPixelData<'a> {
+    /// Creates a new `UnsafeSendPixelData`.
+    ///
+    /// # Safety
+    /// You must call `cairo_surface_mark_dirty()` on the surface once all instances of
+    /// `UnsafeSendPixelData` are dropped to make sure the pixel changes are committed
+    /// to Cairo.
+    #[inline]
+    unsafe fn new(surface: &mut cairo::ImageSurface) -> Self {
+        assert_eq!(surface.get_format(), cairo::Format::ARgb32);
+        let ptr = surface.get_data().unwrap().as_mut_ptr();
+
+        Self {
+            width: surface.get_width() as u32,
+            height: surface.get_height() as u32,
+            stride: surface.get_stride() as isize,
+            ptr: NonNull::new(ptr).unwrap(),
+            _marker: PhantomData,
+        }
+    }
+
+    /// Sets a pixel value at the given coordinates.
+    #[inline]
+    fn set_pixel(&mut self, pixel: Pixel, x: u32, y: u32) {
+        assert!(x < self.width);
+        assert!(y < self.height);
+
+        let value = pixel.to_u32();
+
+        unsafe {
+            let ptr = self
+                .ptr
+                .as_ptr()
+                .offset(y as isize * self.stride + x as isize * 4)
+                as *mut u32;
+            *ptr = value;
+        }
+    }
+
+    /// Splits this `UnsafeSendPixelData` into two at the given row.
+    ///
+    /// The first one contains rows `0..index` (`index` not included) and the second one
+    /// contains rows `index..height`.
+    #[inline]
+    fn split_at_row(self, index: u32) -> (Self, Self) {
+        assert!(index <= self.height);
+
+        (
+            UnsafeSendPixelData {
+                width: self.width,
+                height: index,
+                stride: self.stride,
+                ptr: self.ptr,
+                _marker: PhantomData,
+            },
+            UnsafeSendPixelData {
+                width: self.width,
+                height: self.height - index,
+                stride: self.stride,
+                ptr: NonNull::new(unsafe {
+                    self.ptr.as_ptr().offset(index as isize * self.stride)
+                })
+                .unwrap(),
+                _marker: PhantomData,
+            },
+        )
+    }
+
+    /// Splits this `UnsafeSendPixelData` into two at the given column.
+    ///
+    /// The first one contains columns `0..index` (`index` not included) and the second
+    /// one contains columns `index..width`.
+    #[inline]
+    fn split_at_column(self, index: u32) -> (Self, Self) {
+        assert!(index <= self.width);
+
+        (
+            UnsafeSendPixelData {
+                width: index,
+                height: self.height,
+                stride: self.stride,
+                ptr: self.ptr,
+                _marker: PhantomData,
+            },
+            UnsafeSendPixelData {
+                width: self.width - index,
+                height: self.height,
+                stride: self.stride,
+                ptr: NonNull::new(unsafe { self.ptr.as_ptr().offset(index as isize * 4) })
+                    .unwrap(),
+                _marker: PhantomData,
+            },
+        )
+    }
+}
+
 impl<T> ImageSurface<T> {
     /// Returns the surface width.
     #[inline]
@@ -218,7 +409,7 @@ impl ImageSurface<Shared> {
         height: i32,
         surface_type: SurfaceType,
     ) -> Result<Self, cairo::Status> {
-        let s = cairo::ImageSurface::create(cairo::Format::ARgb32, width, height)?;
+        let s = create_argb32_surface(width, height)?;
 
         SharedImageSurface::wrap(s, surface_type)
     }
@@ -237,6 +428,16 @@ impl ImageSurface<Shared> {
         }
     }
 
+    /// Consumes this `SharedImageSurface` and offers its underlying surface for reuse.
+    ///
+    /// If this is the last reference to the surface, the surface is kept in a
+    /// per-thread pool and handed out again by subsequent same-size allocations;
+    /// otherwise this is equivalent to dropping the `SharedImageSurface`.
+    #[inline]
+    pub fn recycle(self) {
+        return_to_pool(self.surface);
+    }
+
     pub fn from_pixbuf(
         pixbuf: &Pixbuf,
         data: Option<Vec<u8>>,
@@ -364,7 +565,7 @@ impl ImageSurface<Shared> {
     /// `SharedImageSurface` within the given bounds.
     fn copy_surface(&self, bounds: IRect) -> Result<cairo::ImageSurface, cairo::Status> {
         let output_surface =
-            cairo::ImageSurface::create(cairo::Format::ARgb32, self.width, self.height)?;
+            create_argb32_surface(self.width, self.height)?;
 
         let cr = cairo::Context::new(&output_surface);
         let r = cairo::Rectangle::from(bounds);
@@ -387,7 +588,7 @@ impl ImageSurface<Shared> {
         x: f64,
         y: f64,
     ) -> Result<SharedImageSurface, cairo::Status> {
-        let output_surface = cairo::ImageSurface::create(cairo::Format::ARgb32, width, height)?;
+        let output_surface = create_argb32_surface(width, height)?;
 
         {
             let cr = cairo::Context::new(&output_surface);
@@ -424,7 +625,7 @@ impl ImageSurface<Shared> {
     /// Returns a surface with black background and alpha channel matching this surface.
     pub fn extract_alpha(&self, bounds: IRect) -> Result<SharedImageSurface, cairo::Status> {
         let mut output_surface =
-            cairo::ImageSurface::create(cairo::Format::ARgb32, self.width, self.height)?;
+            create_argb32_surface(self.width, self.height)?;
 
         let output_stride = output_surface.get_stride() as usize;
         {
@@ -454,7 +655,7 @@ impl ImageSurface<Shared> {
         let bounds = IRect::from_size(self.width, self.height);
 
         let mut output_surface =
-            cairo::ImageSurface::create(cairo::Format::ARgb32, self.width, self.height)?;
+            create_argb32_surface(self.width, self.height)?;
 
         let stride = output_surface.get_stride() as usize;
         {
@@ -480,7 +681,7 @@ impl ImageSurface<Shared> {
         }
 
         let mut output_surface =
-            cairo::ImageSurface::create(cairo::Format::ARgb32, self.width, self.height)?;
+            create_argb32_surface(self.width, self.height)?;
 
         let stride = output_surface.get_stride() as usize;
         {
@@ -537,7 +738,7 @@ impl ImageSurface<Shared> {
         assert!(kernel.ncols() >= 1);
 
         let mut output_surface =
-            cairo::ImageSurface::create(cairo::Format::ARgb32, self.width, self.height)?;
+            create_argb32_surface(self.width, self.height)?;
 
         let output_stride = output_surface.get_stride() as usize;
         {
@@ -642,128 +843,6 @@ impl ImageSurface<Shared> {
         assert_eq!(self.is_alpha_only(), A::IS_ALPHA_ONLY);
 
         {
-            // The following code is needed for a parallel implementation of the blur loop. The
-            // blurring is done either for each row or for each column of pixels, depending on the
-            // value of `vertical`, independently of the others. Naturally, we want to run the
-            // outer loop on a thread pool.
-            //
-            // The case of `vertical == false` is simple since the input image slice can be
-            // partitioned into chunks for each row of pixels and processed in parallel with rayon.
-            // The case of `vertical == true`, however, is more involved because we can't just make
-            // mutable slices for all pixel columns (they would be overlapping which is forbidden
-            // by the aliasing rules).
-            //
-            // This is where the following struct comes into play: it stores a sub-slice of the
-            // pixel data and can be split at any row or column into two parts (similar to
-            // slice::split_at_mut()).
-            struct UnsafeSendPixelData<'a> {
-                width: u32,
-                height: u32,
-                stride: isize,
-                ptr: NonNull<u8>,
-                _marker: PhantomData<&'a mut ()>,
-            }
-
-            unsafe impl<'a> Send for UnsafeSendPixelData<'a> {}
-
-            impl<'a> UnsafeSendPixelData<'a> {
-                /// Creates a new `UnsafeSendPixelData`.
-                ///
-                /// # Safety
-                /// You must call `cairo_surface_mark_dirty()` on the surface once all instances of
-                /// `UnsafeSendPixelData` are dropped to make sure the pixel changes are committed
-                /// to Cairo.
-                #[inline]
-                unsafe fn new(surface: &mut cairo::ImageSurface) -> Self {
-                    assert_eq!(surface.get_format(), cairo::Format::ARgb32);
-                    let ptr = surface.get_data().unwrap().as_mut_ptr();
-
-                    Self {
-                        width: surface.get_width() as u32,
-                        height: surface.get_height() as u32,
-                        stride: surface.get_stride() as isize,
-                        ptr: NonNull::new(ptr).unwrap(),
-                        _marker: PhantomData,
-                    }
-                }
-
-                /// Sets a pixel value at the given coordinates.
-                #[inline]
-                fn set_pixel(&mut self, pixel: Pixel, x: u32, y: u32) {
-                    assert!(x < self.width);
-                    assert!(y < self.height);
-
-                    let value = pixel.to_u32();
-
-                    unsafe {
-                        let ptr = self
-                            .ptr
-                            .as_ptr()
-                            .offset(y as isize * self.stride + x as isize * 4)
-                            as *mut u32;
-                        *ptr = value;
-                    }
-                }
-
-                /// Splits this `UnsafeSendPixelData` into two at the given row.
-                ///
-                /// The first one contains rows `0..index` (`index` not included) and the second one
-                /// contains rows `index..height`.
-                #[inline]
-                fn split_at_row(self, index: u32) -> (Self, Self) {
-                    assert!(index <= self.height);
-
-                    (
-                        UnsafeSendPixelData {
-                            width: self.width,
-                            height: index,
-                            stride: self.stride,
-                            ptr: self.ptr,
-                            _marker: PhantomData,
-                        },
-                        UnsafeSendPixelData {
-                            width: self.width,
-                            height: self.height - index,
-                            stride: self.stride,
-                            ptr: NonNull::new(unsafe {
-                                self.ptr.as_ptr().offset(index as isize * self.stride)
-                            })
-                            .unwrap(),
-                            _marker: PhantomData,
-                        },
-                    )
-                }
-
-                /// Splits this `UnsafeSendPixelData` into two at the given column.
-                ///
-                /// The first one contains columns `0..index` (`index` not included) and the second
-                /// one contains columns `index..width`.
-                #[inline]
-                fn split_at_column(self, index: u32) -> (Self, Self) {
-                    assert!(index <= self.width);
-
-                    (
-                        UnsafeSendPixelData {
-                            width: index,
-                            height: self.height,
-                            stride: self.stride,
-                            ptr: self.ptr,
-                            _marker: PhantomData,
-                        },
-                        UnsafeSendPixelData {
-                            width: self.width - index,
-                            height: self.height,
-                            stride: self.stride,
-                            ptr: NonNull::new(unsafe {
-                                self.ptr.as_ptr().offset(index as isize * 4)
-                            })
-                            .unwrap(),
-                            _marker: PhantomData,
-                        },
-                    )
-                }
-            }
-
             let output_data = unsafe { UnsafeSendPixelData::new(output_surface) };
 
             // Shift is target into the opposite direction.
@@ -800,101 +879,69 @@ impl ImageSurface<Shared> {
                 output_data.split_at_row(bounds.y0 as u32).1
             };
 
+            // Spawning one task per row or column makes the scheduling overhead comparable to
+            // the work itself on large surfaces (a 4096×4096 blur would spawn 4096 tiny tasks).
+            // Instead, split the rows or columns into contiguous bands, a few per worker thread
+            // to keep the load balanced when some bands finish early.
+            let other_axis_span = (other_axis_max - other_axis_min).max(0) as u32;
+            let band_size = (other_axis_span / (rayon::current_num_threads() as u32 * 4)).max(1);
+
             rayon::scope(|s| {
-                for i in other_axis_min..other_axis_max {
-                    // Split off one row or column and launch its processing on another thread.
-                    // Thanks to the initial split before the loop, there's no special case for the
-                    // very first split.
+                let mut i = other_axis_min;
+                while i < other_axis_max {
+                    let band = min(band_size, (other_axis_max - i) as u32);
+
+                    // Split off a band of rows or columns and launch its processing on another
+                    // thread. Thanks to the initial split before the loop, there's no special
+                    // case for the very first split.
                     let (mut current, remaining) = if B::IS_VERTICAL {
-                        output_data.split_at_column(1)
+                        output_data.split_at_column(band)
                     } else {
-                        output_data.split_at_row(1)
+                        output_data.split_at_row(band)
                     };
 
                     output_data = remaining;
 
                     s.spawn(move |_| {
-                        // Helper function for setting the pixels.
-                        let mut set_pixel = |j, pixel| {
-                            // We're processing rows or columns one-by-one, so the other coordinate
-                            // is always 0.
-                            let (x, y) = if B::IS_VERTICAL { (0, j) } else { (j, 0) };
-                            current.set_pixel(pixel, x, y);
-                        };
-
-                        // The idea is that since all weights of the box blur kernel are equal, for
-                        // each step along the main axis, instead of recomputing the full sum, we
-                        // can take the previous sum, subtract the "oldest" pixel value and add the
-                        // "newest" pixel value.
-                        //
-                        // The sum is u32 so that it can fit MAXIMUM_KERNEL_SIZE * 255.
-                        let mut sum_r = 0;
-                        let mut sum_g = 0;
-                        let mut sum_b = 0;
-                        let mut sum_a = 0;
-
-                        // The whole sum needs to be computed for the first pixel. However, we know
-                        // that values outside of bounds are transparent, so the loop starts on the
-                        // first pixel in bounds.
-                        for j in main_axis_min..min(main_axis_max, main_axis_min + shift) {
-                            let Pixel { r, g, b, a } = pixel(i, j);
-
-                            if !A::IS_ALPHA_ONLY {
-                                sum_r += u32::from(r);
-                                sum_g += u32::from(g);
-                                sum_b += u32::from(b);
-                            }
-
-                            sum_a += u32::from(a);
-                        }
-
-                        set_pixel(
-                            main_axis_min as u32,
-                            Pixel {
-                                r: compute(sum_r),
-                                g: compute(sum_g),
-                                b: compute(sum_b),
-                                a: compute(sum_a),
-                            },
-                        );
-
-                        // Now, go through all the other pixels.
-                        //
-                        // j - target - 1 >= main_axis_min
-                        // j >= main_axis_min + target + 1
-                        let start_subtracting_at = main_axis_min + target + 1;
-
-                        // j + shift - 1 < main_axis_max
-                        // j < main_axis_max - shift + 1
-                        let stop_adding_at = main_axis_max - shift + 1;
-
-                        for j in main_axis_min + 1..main_axis_max {
-                            if j >= start_subtracting_at {
-                                let old_pixel = pixel(i, j - target - 1);
+                        for k in 0..band {
+                            let i = i + k as i32;
+
+                            // Helper function for setting the pixels.
+                            let mut set_pixel = |j, pixel| {
+                                // We're processing rows or columns one-by-one within the band, so the
+                                // other coordinate is the index within the band.
+                                let (x, y) = if B::IS_VERTICAL { (k, j) } else { (j, k) };
+                                current.set_pixel(pixel, x, y);
+                            };
+
+                            // The idea is that since all weights of the box blur kernel are equal, for
+                            // each step along the main axis, instead of recomputing the full sum, we
+                            // can take the previous sum, subtract the "oldest" pixel value and add the
+                            // "newest" pixel value.
+                            //
+                            // The sum is u32 so that it can fit MAXIMUM_KERNEL_SIZE * 255.
+                            let mut sum_r = 0;
+                            let mut sum_g = 0;
+                            let mut sum_b = 0;
+                            let mut sum_a = 0;
+
+                            // The whole sum needs to be computed for the first pixel. However, we know
+                            // that values outside of bounds are transparent, so the loop starts on the
+                            // first pixel in bounds.
+                            for j in main_axis_min..min(main_axis_max, main_axis_min + shift) {
+                                let Pixel { r, g, b, a } = pixel(i, j);
 
                                 if !A::IS_ALPHA_ONLY {
-                                    sum_r -= u32::from(old_pixel.r);
-                                    sum_g -= u32::from(old_pixel.g);
-                                    sum_b -= u32::from(old_pixel.b);
+                                    sum_r += u32::from(r);
+                                    sum_g += u32::from(g);
+                                    sum_b += u32::from(b);
                                 }
 
-                                sum_a -= u32::from(old_pixel.a);
-                            }
-
-                            if j < stop_adding_at {
-                                let new_pixel = pixel(i, j + shift - 1);
-
-                                if !A::IS_ALPHA_ONLY {
-                                    sum_r += u32::from(new_pixel.r);
-                                    sum_g += u32::from(new_pixel.g);
-                                    sum_b += u32::from(new_pixel.b);
-                                }
-
-                                sum_a += u32::from(new_pixel.a);
+                                sum_a += u32::from(a);
                             }
 
                             set_pixel(
-                                j as u32,
+                                main_axis_min as u32,
                                 Pixel {
                                     r: compute(sum_r),
                                     g: compute(sum_g),
@@ -902,8 +949,56 @@ impl ImageSurface<Shared> {
                                     a: compute(sum_a),
                                 },
                             );
+
+                            // Now, go through all the other pixels.
+                            //
+                            // j - target - 1 >= main_axis_min
+                            // j >= main_axis_min + target + 1
+                            let start_subtracting_at = main_axis_min + target + 1;
+
+                            // j + shift - 1 < main_axis_max
+                            // j < main_axis_max - shift + 1
+                            let stop_adding_at = main_axis_max - shift + 1;
+
+                            for j in main_axis_min + 1..main_axis_max {
+                                if j >= start_subtracting_at {
+                                    let old_pixel = pixel(i, j - target - 1);
+
+                                    if !A::IS_ALPHA_ONLY {
+                                        sum_r -= u32::from(old_pixel.r);
+                                        sum_g -= u32::from(old_pixel.g);
+                                        sum_b -= u32::from(old_pixel.b);
+                                    }
+
+                                    sum_a -= u32::from(old_pixel.a);
+                                }
+
+                                if j < stop_adding_at {
+                                    let new_pixel = pixel(i, j + shift - 1);
+
+                                    if !A::IS_ALPHA_ONLY {
+                                        sum_r += u32::from(new_pixel.r);
+                                        sum_g += u32::from(new_pixel.g);
+                                        sum_b += u32::from(new_pixel.b);
+                                    }
+
+                                    sum_a += u32::from(new_pixel.a);
+                                }
+
+                                set_pixel(
+                                    j as u32,
+                                    Pixel {
+                                        r: compute(sum_r),
+                                        g: compute(sum_g),
+                                        b: compute(sum_b),
+                                        a: compute(sum_a),
+                                    },
+                                );
+                            }
                         }
                     });
+
+                    i += band as i32;
                 }
             });
         }
@@ -930,7 +1025,7 @@ impl ImageSurface<Shared> {
         target: usize,
     ) -> Result<SharedImageSurface, cairo::Status> {
         let mut output_surface =
-            cairo::ImageSurface::create(cairo::Format::ARgb32, self.width, self.height)?;
+            create_argb32_surface(self.width, self.height)?;
 
         if self.is_alpha_only() {
             self.box_blur_loop::<B, AlphaOnly>(&mut output_surface, bounds, kernel_size, target);
@@ -941,6 +1036,187 @@ impl ImageSurface<Shared> {
         SharedImageSurface::wrap(output_surface, self.surface_type)
     }
 
+    /// Performs a horizontal or vertical recursive (IIR) approximation of gaussian blur.
+    ///
+    /// This is the third-order recursive filter from Young & van Vliet, "Recursive
+    /// implementation of the Gaussian filter" (1995). Its per-pixel cost doesn't depend on
+    /// the standard deviation: each row or column takes one forward and one backward sweep
+    /// regardless of how large the blur is. Pixels outside of `bounds` are considered
+    /// transparent, like in `box_blur_loop`.
+    // This is public (and not inlined into iir_blur()) for the purpose of accessing it from the
+    // benchmarks.
+    pub fn iir_blur_loop<B: BlurDirection, A: IsAlphaOnly>(
+        &self,
+        output_surface: &mut cairo::ImageSurface,
+        bounds: IRect,
+        std_deviation: f64,
+    ) {
+        assert!(std_deviation > 0.0);
+        assert_eq!(self.is_alpha_only(), A::IS_ALPHA_ONLY);
+
+        // Compute the filter coefficients from the standard deviation; equations 11b and
+        // 8c from the paper.
+        let q = if std_deviation >= 2.5 {
+            0.98711 * std_deviation - 0.96330
+        } else {
+            3.97156 - 4.14554 * (1.0 - 0.26891 * std_deviation).sqrt()
+        };
+
+        let q2 = q * q;
+        let q3 = q2 * q;
+
+        let b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+        let b1 = (2.44413 * q + 2.85619 * q2 + 1.26661 * q3) / b0;
+        let b2 = -(1.4281 * q2 + 1.26661 * q3) / b0;
+        let b3 = 0.422205 * q3 / b0;
+        let scale = 1.0 - (b1 + b2 + b3);
+
+        {
+            let output_data = unsafe { UnsafeSendPixelData::new(output_surface) };
+
+            // See box_blur_loop() for the main and other axis terminology.
+            let (main_axis_min, main_axis_max, other_axis_min, other_axis_max) = if B::IS_VERTICAL {
+                (bounds.y0, bounds.y1, bounds.x0, bounds.x1)
+            } else {
+                (bounds.x0, bounds.x1, bounds.y0, bounds.y1)
+            };
+
+            let main_axis_span = (main_axis_max - main_axis_min).max(0) as usize;
+
+            // Helper function for getting the pixels.
+            let pixel = |i, j| {
+                let (x, y) = if B::IS_VERTICAL { (i, j) } else { (j, i) };
+
+                self.get_pixel(x as u32, y as u32)
+            };
+
+            // The following loop assumes the first row or column of `output_data` is the first row
+            // or column inside `bounds`.
+            let mut output_data = if B::IS_VERTICAL {
+                output_data.split_at_column(bounds.x0 as u32).1
+            } else {
+                output_data.split_at_row(bounds.y0 as u32).1
+            };
+
+            // Parallelize over contiguous bands of rows or columns, like box_blur_loop().
+            let other_axis_span = (other_axis_max - other_axis_min).max(0) as u32;
+            let band_size = (other_axis_span / (rayon::current_num_threads() as u32 * 4)).max(1);
+
+            rayon::scope(|s| {
+                let mut i = other_axis_min;
+                while i < other_axis_max {
+                    let band = min(band_size, (other_axis_max - i) as u32);
+
+                    let (mut current, remaining) = if B::IS_VERTICAL {
+                        output_data.split_at_column(band)
+                    } else {
+                        output_data.split_at_row(band)
+                    };
+
+                    output_data = remaining;
+
+                    s.spawn(move |_| {
+                        // Intermediate forward-sweep values for one scanline, reused
+                        // across the rows or columns of the band.
+                        let mut line = vec![[0f64; 4]; main_axis_span];
+
+                        let channels = if A::IS_ALPHA_ONLY { 3..4 } else { 0..4 };
+
+                        for k in 0..band {
+                            let i = i + k as i32;
+
+                            // Forward sweep. The recursion state starts at zero since
+                            // everything before the first pixel is transparent.
+                            let mut w1 = [0f64; 4];
+                            let mut w2 = [0f64; 4];
+                            let mut w3 = [0f64; 4];
+
+                            for (n, j) in (main_axis_min..main_axis_max).enumerate() {
+                                let Pixel { r, g, b, a } = pixel(i, j);
+                                let input =
+                                    [f64::from(r), f64::from(g), f64::from(b), f64::from(a)];
+
+                                let mut w0 = [0f64; 4];
+                                for c in channels.clone() {
+                                    w0[c] =
+                                        scale * input[c] + b1 * w1[c] + b2 * w2[c] + b3 * w3[c];
+                                }
+
+                                line[n] = w0;
+                                w3 = w2;
+                                w2 = w1;
+                                w1 = w0;
+                            }
+
+                            // Backward sweep, producing the output pixels.
+                            let mut y1 = [0f64; 4];
+                            let mut y2 = [0f64; 4];
+                            let mut y3 = [0f64; 4];
+
+                            for (n, j) in (main_axis_min..main_axis_max).enumerate().rev() {
+                                let w0 = line[n];
+
+                                let mut y0 = [0f64; 4];
+                                for c in channels.clone() {
+                                    y0[c] = scale * w0[c] + b1 * y1[c] + b2 * y2[c] + b3 * y3[c];
+                                }
+
+                                let compute = |v: f64| (v + 0.5).max(0.0).min(255.0) as u8;
+
+                                let (x, y) = if B::IS_VERTICAL {
+                                    (k, j as u32)
+                                } else {
+                                    (j as u32, k)
+                                };
+                                current.set_pixel(
+                                    Pixel {
+                                        r: compute(y0[0]),
+                                        g: compute(y0[1]),
+                                        b: compute(y0[2]),
+                                        a: compute(y0[3]),
+                                    },
+                                    x,
+                                    y,
+                                );
+
+                                y3 = y2;
+                                y2 = y1;
+                                y1 = y0;
+                            }
+                        }
+                    });
+
+                    i += band as i32;
+                }
+            });
+        }
+
+        // Don't forget to manually mark the surface as dirty (due to usage of
+        // `UnsafeSendPixelData`).
+        unsafe { cairo_sys::cairo_surface_mark_dirty(output_surface.to_raw_none()) }
+    }
+
+    /// Performs a horizontal or vertical recursive (IIR) approximation of gaussian blur.
+    ///
+    /// Unlike `box_blur`, the cost doesn't grow with `std_deviation`, so this is the
+    /// preferred path for large deviations.
+    #[inline]
+    pub fn iir_blur<B: BlurDirection>(
+        &self,
+        bounds: IRect,
+        std_deviation: f64,
+    ) -> Result<SharedImageSurface, cairo::Status> {
+        let mut output_surface = create_argb32_surface(self.width, self.height)?;
+
+        if self.is_alpha_only() {
+            self.iir_blur_loop::<B, AlphaOnly>(&mut output_surface, bounds, std_deviation);
+        } else {
+            self.iir_blur_loop::<B, NotAlphaOnly>(&mut output_surface, bounds, std_deviation);
+        }
+
+        SharedImageSurface::wrap(output_surface, self.surface_type)
+    }
+
     /// Fills the with a specified color.
     #[inline]
     pub fn flood(
@@ -950,7 +1226,7 @@ impl ImageSurface<Shared> {
         opacity: UnitInterval,
     ) -> Result<SharedImageSurface, cairo::Status> {
         let output_surface =
-            cairo::ImageSurface::create(cairo::Format::ARgb32, self.width, self.height)?;
+            create_argb32_surface(self.width, self.height)?;
 
         if opacity.0 > 0.0 {
             let cr = cairo::Context::new(&output_surface);
@@ -979,7 +1255,7 @@ impl ImageSurface<Shared> {
         dy: f64,
     ) -> Result<SharedImageSurface, cairo::Status> {
         let output_surface =
-            cairo::ImageSurface::create(cairo::Format::ARgb32, self.width, self.height)?;
+            create_argb32_surface(self.width, self.height)?;
 
         // output_bounds contains all pixels within bounds,
         // for which (x - ox) and (y - oy) also lie within bounds.
@@ -1009,7 +1285,7 @@ impl ImageSurface<Shared> {
         rect: Option<Rect>,
     ) -> Result<SharedImageSurface, cairo::Status> {
         let output_surface =
-            cairo::ImageSurface::create(cairo::Format::ARgb32, self.width, self.height)?;
+            create_argb32_surface(self.width, self.height)?;
 
         if rect.is_none() || !rect.unwrap().is_empty() {
             let cr = cairo::Context::new(&output_surface);
@@ -1043,7 +1319,7 @@ impl ImageSurface<Shared> {
     #[inline]
     pub fn tile(&self, bounds: IRect) -> Result<SharedImageSurface, cairo::Status> {
         let output_surface =
-            cairo::ImageSurface::create(cairo::Format::ARgb32, bounds.width(), bounds.height())?;
+            create_argb32_surface(bounds.width(), bounds.height())?;
 
         {
             let cr = cairo::Context::new(&output_surface);
@@ -1065,7 +1341,7 @@ impl ImageSurface<Shared> {
         y: i32,
     ) -> Result<SharedImageSurface, cairo::Status> {
         let output_surface =
-            cairo::ImageSurface::create(cairo::Format::ARgb32, self.width, self.height)?;
+            create_argb32_surface(self.width, self.height)?;
 
         {
             let cr = cairo::Context::new(&output_surface);
@@ -1160,37 +1436,52 @@ pub fn composite_arithmetic(
     k4: f64,
 ) {
     output_surface.modify(&mut |data, stride| {
-        for (x, y, pixel, pixel_2) in
-            Pixels::within(surface1, bounds).map(|(x, y, p)| (x, y, p, surface2.get_pixel(x, y)))
-        {
-            let i1a = f64::from(pixel.a) / 255f64;
-            let i2a = f64::from(pixel_2.a) / 255f64;
-            let oa = k1 * i1a * i2a + k2 * i1a + k3 * i2a + k4;
-            let oa = clamp(oa, 0f64, 1f64);
-
-            // Contents of image surfaces are transparent by default, so if the resulting pixel is
-            // transparent there's no need to do anything.
-            if oa > 0f64 {
-                let compute = |i1, i2| {
-                    let i1 = f64::from(i1) / 255f64;
-                    let i2 = f64::from(i2) / 255f64;
-
-                    let o = k1 * i1 * i2 + k2 * i1 + k3 * i2 + k4;
-                    let o = clamp(o, 0f64, oa);
-
-                    ((o * 255f64) + 0.5) as u8
-                };
+        // Composite the rows on the rayon thread pool: every output pixel only
+        // depends on the two input pixels at the same position.
+        let first_row = bounds.y0 as usize;
+        let one_past_last_row = bounds.y1 as usize;
+
+        let slice = &mut data[first_row * stride..one_past_last_row * stride];
+
+        slice
+            .par_chunks_mut(stride)
+            .zip(bounds.y_range())
+            .for_each(|(row, y)| {
+                let mut row = row;
+
+                for x in bounds.x_range() {
+                    let pixel = surface1.get_pixel(x as u32, y as u32);
+                    let pixel_2 = surface2.get_pixel(x as u32, y as u32);
+
+                    let i1a = f64::from(pixel.a) / 255f64;
+                    let i2a = f64::from(pixel_2.a) / 255f64;
+                    let oa = k1 * i1a * i2a + k2 * i1a + k3 * i2a + k4;
+                    let oa = clamp(oa, 0f64, 1f64);
+
+                    // Contents of image surfaces are transparent by default, so if the
+                    // resulting pixel is transparent there's no need to do anything.
+                    if oa > 0f64 {
+                        let compute = |i1, i2| {
+                            let i1 = f64::from(i1) / 255f64;
+                            let i2 = f64::from(i2) / 255f64;
+
+                            let o = k1 * i1 * i2 + k2 * i1 + k3 * i2 + k4;
+                            let o = clamp(o, 0f64, oa);
+
+                            ((o * 255f64) + 0.5) as u8
+                        };
 
-                let output_pixel = Pixel {
-                    r: compute(pixel.r, pixel_2.r),
-                    g: compute(pixel.g, pixel_2.g),
-                    b: compute(pixel.b, pixel_2.b),
-                    a: ((oa * 255f64) + 0.5) as u8,
-                };
+                        let output_pixel = Pixel {
+                            r: compute(pixel.r, pixel_2.r),
+                            g: compute(pixel.g, pixel_2.g),
+                            b: compute(pixel.b, pixel_2.b),
+                            a: ((oa * 255f64) + 0.5) as u8,
+                        };
 
-                data.set_pixel(stride, output_pixel, x, y);
-            }
-        }
+                        row.set_pixel(stride, output_pixel, x as u32, 0);
+                    }
+                }
+            });
     });
 }
 
@@ -1201,7 +1492,7 @@ impl ImageSurface<Exclusive> {
         height: i32,
         surface_type: SurfaceType,
     ) -> Result<ExclusiveImageSurface, cairo::Status> {
-        let surface = cairo::ImageSurface::create(cairo::Format::ARgb32, width, height)?;
+        let surface = create_argb32_surface(width, height)?;
 
         let (width, height) = (surface.get_width(), surface.get_height());
 
@@ -1301,4 +1592,26 @@ mod tests {
             }
         }
     }
+
+    #[test]
+    fn test_recycled_surface_is_reused_and_cleared() {
+        const WIDTH: i32 = 101;
+        const HEIGHT: i32 = 103;
+
+        let mut surface = ExclusiveImageSurface::new(WIDTH, HEIGHT, SurfaceType::SRgb).unwrap();
+
+        // Dirty the surface so we can check that reuse clears it.
+        for x in surface.get_data().iter_mut() {
+            *x = 0xff;
+        }
+
+        let surface = surface.share().unwrap();
+        let ptr = surface.surface.to_raw_none();
+        surface.recycle();
+
+        // Same size: must come back from the pool, fully cleared.
+        let mut surface = ExclusiveImageSurface::new(WIDTH, HEIGHT, SurfaceType::SRgb).unwrap();
+        assert_eq!(surface.surface.to_raw_none(), ptr);
+        assert!(surface.get_data().iter().all(|&x| x == 0));
+    }
 }
@@ -35,14 +35,19 @@ pub fn map_unpremultiplied_components_loop<F: Fn(u8) -> u8>(
     output_surface.modify(&mut |data, stride| {
         for (x, y, pixel) in Pixels::within(surface, bounds) {
             if pixel.a > 0 {
-                let alpha = f64::from(pixel.a) / 255f64;
+                // All of the arithmetic here is done through lookup tables and integer math;
+                // the previous per-component f64 division and multiplication dominated the
+                // cost of linearization on large surfaces.
+                let unpremultiply = &UNPREMULTIPLY[usize::from(pixel.a)];
+                let alpha = u32::from(pixel.a);
 
                 let compute = |x| {
-                    let x = f64::from(x) / alpha; // Unpremultiply alpha.
-                    let x = (x + 0.5) as u8; // Round to nearest u8.
+                    let x = unpremultiply[usize::from(x)]; // Unpremultiply alpha.
                     let x = f(x);
-                    let x = f64::from(x) * alpha; // Premultiply alpha again.
-                    (x + 0.5) as u8
+                    // Premultiply alpha again, rounding to nearest. The shift-add sequence
+                    // computes an exact rounding division by 255.
+                    let t = u32::from(x) * alpha + 128;
+                    ((t + (t >> 8)) >> 8) as u8
                 };
 
                 let output_pixel = Pixel {
@@ -98,3 +103,33 @@ pub fn unlinearize_surface(
 
     map_unpremultiplied_components(surface, bounds, unlinearize, SurfaceType::SRgb)
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn unpremultiply_table_matches_float_math() {
+        for a in 1..=255u16 {
+            let alpha = f64::from(a) / 255.0;
+
+            for x in 0..=255u16 {
+                let reference = (f64::from(x) / alpha + 0.5) as u8;
+                assert_eq!(UNPREMULTIPLY[usize::from(a)][usize::from(x)], reference);
+            }
+        }
+    }
+
+    #[test]
+    fn premultiply_rounding_matches_float_math() {
+        for a in 0..=255u32 {
+            let alpha = f64::from(a) / 255.0;
+
+            for x in 0..=255u32 {
+                let reference = (f64::from(x) * alpha + 0.5) as u8;
+                let t = x * a + 128;
+                assert_eq!(((t + (t >> 8)) >> 8) as u8, reference);
+            }
+        }
+    }
+}
@@ -3,6 +3,7 @@
 use markup5ever::{expanded_name, local_name, namespace_url, ns};
 use pango::FontMapExt;
 use std::cell::RefCell;
+use std::collections::HashMap;
 
 use crate::allowed_url::Fragment;
 use crate::bbox::BoundingBox;
@@ -940,6 +941,40 @@ fn get_pango_context(cr: &cairo::Context, is_testing: bool) -> pango::Context {
     context
 }
 
+/// Cache key for shaped Pango layouts.
+///
+/// Shaping is the most expensive part of text rendering, and identical labels
+/// (same text, same resolved font properties) recur constantly in label-heavy
+/// documents and across repeated renders.  The key captures every input that
+/// create_pango_layout() feeds into Pango.  The transform components of the
+/// cairo context matter too, since pango_cairo_update_context() picks up the
+/// current transformation for hinting, so their linear part is keyed as raw
+/// bits.
+#[derive(PartialEq, Eq, Hash)]
+struct LayoutCacheKey {
+    text: String,
+    font_desc: String,
+    language: String,
+    gravity: pango::Gravity,
+    base_dir: pango::Direction,
+    alignment: pango::Alignment,
+    letter_spacing: i32,
+    underline: bool,
+    strike: bool,
+    transform: [u64; 4],
+    is_testing: bool,
+}
+
+// Pango layouts are per-thread objects (they are not Send), so the cache is
+// thread-local.  Cloning a pango::Layout only takes a reference; cached
+// layouts are shared, never mutated after creation.
+thread_local! {
+    static LAYOUT_CACHE: RefCell<HashMap<LayoutCacheKey, pango::Layout>> =
+        RefCell::new(HashMap::new());
+}
+
+const LAYOUT_CACHE_MAX_ENTRIES: usize = 256;
+
 fn create_pango_layout(
     draw_ctx: &DrawingCtx,
     values: &ComputedValues,
@@ -984,18 +1019,40 @@ fn create_pango_layout(
         values.font_size().0.normalize(values, &params),
     ));
 
+    let letter_spacing = to_pango_units(values.letter_spacing().0.normalize(values, &params));
+    let alignment = pango::Alignment::from(values.direction());
+
+    let matrix = cr.get_matrix();
+    let key = LayoutCacheKey {
+        text: text.to_string(),
+        font_desc: font_desc.to_string().to_string(),
+        language: values.xml_lang().0.clone(),
+        gravity: pango_context.get_base_gravity(),
+        base_dir: pango_context.get_base_dir(),
+        alignment,
+        letter_spacing,
+        underline: values.text_decoration().underline,
+        strike: values.text_decoration().strike,
+        transform: [
+            matrix.xx.to_bits(),
+            matrix.yx.to_bits(),
+            matrix.xy.to_bits(),
+            matrix.yy.to_bits(),
+        ],
+        is_testing: draw_ctx.is_testing(),
+    };
+
+    if let Some(layout) = LAYOUT_CACHE.with(|cache| cache.borrow().get(&key).cloned()) {
+        return layout;
+    }
+
     let layout = pango::Layout::new(&pango_context);
     layout.set_auto_dir(false);
     layout.set_font_description(Some(&font_desc));
 
     let attr_list = pango::AttrList::new();
 
-    attr_list.insert(
-        pango::Attribute::new_letter_spacing(to_pango_units(
-            values.letter_spacing().0.normalize(values, &params),
-        ))
-        .unwrap(),
-    );
+    attr_list.insert(pango::Attribute::new_letter_spacing(letter_spacing).unwrap());
 
     if values.text_decoration().underline {
         attr_list.insert(pango::Attribute::new_underline(pango::Underline::Single).unwrap());
@@ -1006,8 +1063,16 @@ fn create_pango_layout(
     }
 
     layout.set_attributes(Some(&attr_list));
-    layout.set_alignment(pango::Alignment::from(values.direction()));
+    layout.set_alignment(alignment);
     layout.set_text(text);
 
+    LAYOUT_CACHE.with(|cache| {
+        let mut cache = cache.borrow_mut();
+        if cache.len() >= LAYOUT_CACHE_MAX_ENTRIES {
+            cache.clear();
+        }
+        cache.insert(key, layout.clone());
+    });
+
     layout
 }
@@ -24,6 +24,7 @@ use crate::node::{Node, NodeBorrow};
 use crate::property_bag::PropertyBag;
 use crate::style::StyleType;
 use crate::xml2_load::Xml2Parser;
+use crate::xml_cache::{self, EventRecorder};
 
 #[derive(Clone)]
 enum Context {
@@ -103,6 +104,12 @@ struct XmlStateInner {
     current_node: Option<Node>,
 
     entities: HashMap<String, XmlEntityPtr>,
+
+    // Optional recorder for the pre-parsed event cache; see the xml_cache module.
+    recorder: Option<EventRecorder>,
+    // Incremented while parsing documents pulled in through xi:include, whose
+    // events must not end up in the recording.
+    recording_suspended: usize,
 }
 
 pub struct XmlState {
@@ -131,7 +138,11 @@ impl XmlStateInner {
 }
 
 impl XmlState {
-    fn new(document_builder: DocumentBuilder, unlimited_size: bool) -> XmlState {
+    fn new(
+        document_builder: DocumentBuilder,
+        unlimited_size: bool,
+        recorder: Option<EventRecorder>,
+    ) -> XmlState {
         XmlState {
             inner: RefCell::new(XmlStateInner {
                 weak: None,
@@ -140,12 +151,32 @@ impl XmlState {
                 context_stack: vec![Context::Start],
                 current_node: None,
                 entities: HashMap::new(),
+                recorder,
+                recording_suspended: 0,
             }),
 
             unlimited_size,
         }
     }
 
+    fn record<F: FnOnce(&mut EventRecorder)>(&self, f: F) {
+        let mut inner = self.inner.borrow_mut();
+
+        if inner.recording_suspended == 0 {
+            if let Some(ref mut recorder) = inner.recorder {
+                f(recorder);
+            }
+        }
+    }
+
+    fn take_recording(&self) -> Option<Vec<u8>> {
+        self.inner
+            .borrow_mut()
+            .recorder
+            .take()
+            .map(|r| r.into_bytes())
+    }
+
     fn check_last_error(&self) -> Result<(), LoadingError> {
         let inner = self.inner.borrow();
 
@@ -176,6 +207,8 @@ impl XmlState {
             return Err(());
         }
 
+        self.record(|r| r.start_element(&name, pbag));
+
         self.inner.borrow_mut().num_loaded_elements += 1;
 
         let new_context = match context {
@@ -200,6 +233,8 @@ impl XmlState {
     }
 
     pub fn end_element(&self, _name: QualName) {
+        self.record(|r| r.end_element());
+
         let context = self.inner.borrow().context();
 
         match context {
@@ -221,6 +256,8 @@ impl XmlState {
     }
 
     pub fn characters(&self, text: &str) {
+        self.record(|r| r.characters(text));
+
         let context = self.inner.borrow().context();
 
         match context {
@@ -245,6 +282,8 @@ impl XmlState {
     }
 
     pub fn processing_instruction(&self, target: &str, data: &str) {
+        self.record(|r| r.processing_instruction(target, data));
+
         if target != "xml-stylesheet" {
             return;
         }
@@ -553,15 +592,23 @@ impl XmlState {
             _ => AcquireError::ResourceError,
         })?;
 
+        // The xi:include element itself is recorded; its content is re-acquired when
+        // the recording is replayed, so don't record the nested document's events.
+        self.inner.borrow_mut().recording_suspended += 1;
+
         // FIXME: pass a cancellable
-        self.parse_from_stream(&stream, None).map_err(|e| match e {
+        let res = self.parse_from_stream(&stream, None).map_err(|e| match e {
             LoadingError::CouldNotCreateXmlParser => {
                 AcquireError::FatalError(String::from("could not create XML parser"))
             }
             LoadingError::Glib(_) => AcquireError::ResourceError,
             LoadingError::XmlParseError(s) => AcquireError::FatalError(s),
             _ => AcquireError::FatalError(String::from("unknown error")),
-        })
+        });
+
+        self.inner.borrow_mut().recording_suspended -= 1;
+
+        res
     }
 
     // Parses XML from a stream into an XmlState.
@@ -687,7 +734,7 @@ pub fn xml_load_from_possibly_compressed_stream(
     stream: &gio::InputStream,
     cancellable: Option<&gio::Cancellable>,
 ) -> Result<Document, LoadingError> {
-    let state = Rc::new(XmlState::new(document_builder, unlimited_size));
+    let state = Rc::new(XmlState::new(document_builder, unlimited_size, None));
 
     state.inner.borrow_mut().weak = Some(Rc::downgrade(&state));
 
@@ -696,6 +743,93 @@ pub fn xml_load_from_possibly_compressed_stream(
     state.build_document(&stream, cancellable)
 }
 
+/// Like `xml_load_from_possibly_compressed_stream`, but also returns the serialized
+/// event stream for the pre-parsed cache; see the `xml_cache` module.
+pub fn xml_load_from_possibly_compressed_stream_recording(
+    document_builder: DocumentBuilder,
+    unlimited_size: bool,
+    stream: &gio::InputStream,
+    cancellable: Option<&gio::Cancellable>,
+) -> Result<(Document, Vec<u8>), LoadingError> {
+    let state = Rc::new(XmlState::new(
+        document_builder,
+        unlimited_size,
+        Some(EventRecorder::new()),
+    ));
+
+    state.inner.borrow_mut().weak = Some(Rc::downgrade(&state));
+
+    let stream = get_input_stream_for_loading(stream, cancellable)?;
+
+    let document = state.build_document(&stream, cancellable)?;
+    let recording = state.take_recording().unwrap();
+
+    Ok((document, recording))
+}
+
+/// Incrementally parses a document from caller-supplied chunks of bytes.
+///
+/// This drives libxml2's push parser, so parsing overlaps with whatever I/O
+/// produces the bytes, and well-formedness errors surface as soon as the
+/// offending chunk arrives instead of at the end of the transfer.  Compressed
+/// documents are not supported; callers must detect those and fall back to
+/// buffering the whole payload.
+pub struct XmlPushParser {
+    state: Rc<XmlState>,
+    parser: Box<Xml2Parser>,
+}
+
+impl XmlPushParser {
+    pub fn new(
+        document_builder: DocumentBuilder,
+        unlimited_size: bool,
+    ) -> Result<XmlPushParser, LoadingError> {
+        let state = Rc::new(XmlState::new(document_builder, unlimited_size, None));
+
+        state.inner.borrow_mut().weak = Some(Rc::downgrade(&state));
+
+        let parser = Xml2Parser::from_push(state.clone(), unlimited_size)?;
+
+        Ok(XmlPushParser { state, parser })
+    }
+
+    pub fn write(&self, buf: &[u8]) -> Result<(), LoadingError> {
+        self.parser.feed(buf)?;
+        self.state.check_last_error()
+    }
+
+    pub fn close(self) -> Result<Document, LoadingError> {
+        self.parser.finish()?;
+        self.state.check_last_error()?;
+
+        self.state
+            .inner
+            .borrow_mut()
+            .document_builder
+            .take()
+            .unwrap()
+            .build()
+    }
+}
+
+/// Loads a document by replaying a serialized event stream produced by
+/// `xml_load_from_possibly_compressed_stream_recording`.
+pub fn xml_load_from_cache(
+    document_builder: DocumentBuilder,
+    unlimited_size: bool,
+    data: &[u8],
+) -> Result<Document, LoadingError> {
+    let state = Rc::new(XmlState::new(document_builder, unlimited_size, None));
+
+    state.inner.borrow_mut().weak = Some(Rc::downgrade(&state));
+
+    xml_cache::replay_events(data, &state)?;
+    state.check_last_error()?;
+
+    let builder = state.inner.borrow_mut().document_builder.take().unwrap();
+    builder.build()
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -443,6 +443,87 @@ impl Xml2Parser {
         }
     }
 
+    /// Creates a parser in push mode, for feeding bytes incrementally with
+    /// [`feed`] and [`finish`].
+    ///
+    /// [`feed`]: #method.feed
+    /// [`finish`]: #method.finish
+    pub fn from_push(
+        state: Rc<XmlState>,
+        unlimited_size: bool,
+    ) -> Result<Box<Xml2Parser>, LoadingError> {
+        init_libxml2();
+
+        let mut sax_handler = get_xml2_sax_handler();
+
+        let mut xml2_parser = Box::new(Xml2Parser {
+            parser: Cell::new(ptr::null_mut()),
+            state,
+            gio_error: Rc::new(RefCell::new(None)),
+        });
+
+        unsafe {
+            let parser = xmlCreatePushParserCtxt(
+                &mut sax_handler,
+                xml2_parser.as_mut() as *mut _ as *mut _,
+                ptr::null(),
+                0,
+                ptr::null(),
+            );
+
+            if parser.is_null() {
+                Err(LoadingError::CouldNotCreateXmlParser)
+            } else {
+                xml2_parser.parser.set(parser);
+
+                set_xml_parse_options(parser, unlimited_size);
+
+                Ok(xml2_parser)
+            }
+        }
+    }
+
+    /// Feeds a chunk of bytes to a push-mode parser.
+    ///
+    /// Returns an error as soon as libxml2 detects that the document is not
+    /// well-formed, without waiting for the rest of it.
+    pub fn feed(&self, buf: &[u8]) -> Result<(), LoadingError> {
+        // xmlParseChunk() takes the chunk size as an int, so feed huge
+        // buffers piecewise.
+        for chunk in buf.chunks(std::i32::MAX as usize) {
+            self.parse_chunk(chunk, false)?;
+        }
+
+        Ok(())
+    }
+
+    /// Tells a push-mode parser that there are no more bytes coming.
+    pub fn finish(&self) -> Result<(), LoadingError> {
+        self.parse_chunk(&[], true)
+    }
+
+    fn parse_chunk(&self, buf: &[u8], terminate: bool) -> Result<(), LoadingError> {
+        unsafe {
+            let parser = self.parser.get();
+
+            let chunk = if buf.is_empty() {
+                ptr::null()
+            } else {
+                buf.as_ptr() as *const libc::c_char
+            };
+
+            let terminate = if terminate { 1 } else { 0 };
+
+            if xmlParseChunk(parser, chunk, buf.len() as libc::c_int, terminate) != 0 {
+                let xerr = xmlCtxtGetLastError(parser as *mut _);
+                let msg = xml2_error_to_string(xerr);
+                Err(LoadingError::XmlParseError(msg))
+            } else {
+                Ok(())
+            }
+        }
+    }
+
     pub fn parse(&self) -> Result<(), LoadingError> {
         unsafe {
             let parser = self.parser.get();
@@ -0,0 +1,310 @@
+//! Binary cache of pre-parsed XML events.
+//!
+//! Loading an SVG document is dominated by the XML parse: libxml2, entity handling, and
+//! decompression all run before the first node is built.  Workloads that load the same
+//! documents on every process start can instead parse once, save the SAX-level events to
+//! a binary file, and on subsequent loads replay those events straight into [`XmlState`],
+//! skipping libxml2 entirely.
+//!
+//! The format is a magic string, a version number, and then a flat sequence of tagged
+//! records.  Strings are stored as a little-endian `u32` length followed by UTF-8 bytes.
+//! Readers must reject files whose magic or version do not match, at which point callers
+//! are expected to fall back to parsing the original XML.
+//!
+//! Events from documents pulled in through `<xi:include>` are *not* stored; the
+//! `xi:include` element itself is, so replaying re-acquires the included resources the
+//! same way the original parse did.
+//!
+//! [`XmlState`]: ../xml/struct.XmlState.html
+
+use std::str;
+
+use markup5ever::{namespace_url, ns, LocalName, Namespace, Prefix, QualName};
+
+use crate::error::LoadingError;
+use crate::property_bag::PropertyBag;
+use crate::xml::XmlState;
+
+/// Identifies a pre-parsed event cache file.
+const MAGIC: &[u8] = b"RsvgXmlCache";
+
+/// Version of the serialization format.
+///
+/// Bump this whenever the record layout changes; old files will then be rejected and
+/// regenerated from the XML.
+const FORMAT_VERSION: u32 = 1;
+
+const TAG_START_ELEMENT: u8 = 1;
+const TAG_END_ELEMENT: u8 = 2;
+const TAG_CHARACTERS: u8 = 3;
+const TAG_PROCESSING_INSTRUCTION: u8 = 4;
+
+/// Accumulates XML events during a parse, in the serialized cache format.
+pub struct EventRecorder {
+    buf: Vec<u8>,
+}
+
+impl EventRecorder {
+    pub fn new() -> EventRecorder {
+        let mut buf = Vec::new();
+        buf.extend_from_slice(MAGIC);
+        buf.extend_from_slice(&FORMAT_VERSION.to_le_bytes());
+
+        EventRecorder { buf }
+    }
+
+    /// Returns the serialized event stream, consuming the recorder.
+    pub fn into_bytes(self) -> Vec<u8> {
+        self.buf
+    }
+
+    pub fn start_element(&mut self, name: &QualName, pbag: &PropertyBag) {
+        self.buf.push(TAG_START_ELEMENT);
+        self.write_qual_name(name);
+        self.write_u32(pbag.len() as u32);
+
+        for (attr, value) in pbag.iter() {
+            self.write_qual_name(&attr);
+            self.write_str(value);
+        }
+    }
+
+    pub fn end_element(&mut self) {
+        self.buf.push(TAG_END_ELEMENT);
+    }
+
+    pub fn characters(&mut self, text: &str) {
+        self.buf.push(TAG_CHARACTERS);
+        self.write_str(text);
+    }
+
+    pub fn processing_instruction(&mut self, target: &str, data: &str) {
+        self.buf.push(TAG_PROCESSING_INSTRUCTION);
+        self.write_str(target);
+        self.write_str(data);
+    }
+
+    fn write_u32(&mut self, n: u32) {
+        self.buf.extend_from_slice(&n.to_le_bytes());
+    }
+
+    fn write_str(&mut self, s: &str) {
+        self.write_u32(s.len() as u32);
+        self.buf.extend_from_slice(s.as_bytes());
+    }
+
+    fn write_opt_str(&mut self, s: Option<&str>) {
+        match s {
+            Some(s) => {
+                self.buf.push(1);
+                self.write_str(s);
+            }
+
+            None => self.buf.push(0),
+        }
+    }
+
+    fn write_qual_name(&mut self, name: &QualName) {
+        self.write_opt_str(name.prefix.as_ref().map(|p| p.as_ref()));
+        self.write_str(name.ns.as_ref());
+        self.write_str(name.local.as_ref());
+    }
+}
+
+/// Replays a serialized event stream into an `XmlState`.
+///
+/// Returns an error if the data is not a valid cache file of the current
+/// [`FORMAT_VERSION`]; the caller should then fall back to parsing the XML.
+///
+/// [`FORMAT_VERSION`]: constant.FORMAT_VERSION.html
+pub fn replay_events(data: &[u8], state: &XmlState) -> Result<(), LoadingError> {
+    let mut reader = EventReader::new(data)?;
+
+    while let Some(tag) = reader.read_tag() {
+        match tag {
+            TAG_START_ELEMENT => {
+                let name = reader.read_qual_name()?;
+                let n_attrs = reader.read_u32()? as usize;
+
+                let mut attrs = Vec::with_capacity(n_attrs);
+                for _ in 0..n_attrs {
+                    let attr = reader.read_qual_name()?;
+                    let value = reader.read_str()?;
+                    attrs.push((attr, value));
+                }
+
+                let pbag = PropertyBag::new_from_pairs(&attrs);
+
+                if state.start_element(name, &pbag).is_err() {
+                    // The state has already recorded a fatal error; stop replaying, just
+                    // like the SAX callbacks stop feeding events.
+                    return Ok(());
+                }
+            }
+
+            TAG_END_ELEMENT => {
+                // XmlState ignores the element name on end_element.
+                state.end_element(QualName::new(None, ns!(), LocalName::from("")));
+            }
+
+            TAG_CHARACTERS => {
+                state.characters(reader.read_str()?);
+            }
+
+            TAG_PROCESSING_INSTRUCTION => {
+                let target = reader.read_str()?;
+                let data = reader.read_str()?;
+                state.processing_instruction(target, data);
+            }
+
+            _ => return Err(invalid_cache("unknown record tag")),
+        }
+    }
+
+    Ok(())
+}
+
+fn invalid_cache(msg: &str) -> LoadingError {
+    LoadingError::XmlParseError(format!("invalid pre-parsed XML cache: {}", msg))
+}
+
+struct EventReader<'a> {
+    data: &'a [u8],
+    pos: usize,
+}
+
+impl<'a> EventReader<'a> {
+    fn new(data: &'a [u8]) -> Result<EventReader<'a>, LoadingError> {
+        if data.len() < MAGIC.len() + 4 || &data[..MAGIC.len()] != MAGIC {
+            return Err(invalid_cache("bad magic"));
+        }
+
+        let mut reader = EventReader {
+            data,
+            pos: MAGIC.len(),
+        };
+
+        let version = reader.read_u32()?;
+        if version != FORMAT_VERSION {
+            return Err(invalid_cache(&format!(
+                "version mismatch, got {} but expected {}",
+                version, FORMAT_VERSION
+            )));
+        }
+
+        Ok(reader)
+    }
+
+    fn read_tag(&mut self) -> Option<u8> {
+        if self.pos < self.data.len() {
+            let tag = self.data[self.pos];
+            self.pos += 1;
+            Some(tag)
+        } else {
+            None
+        }
+    }
+
+    fn read_u32(&mut self) -> Result<u32, LoadingError> {
+        if self.data.len() - self.pos < 4 {
+            return Err(invalid_cache("truncated data"));
+        }
+
+        let mut bytes = [0; 4];
+        bytes.copy_from_slice(&self.data[self.pos..self.pos + 4]);
+        self.pos += 4;
+
+        Ok(u32::from_le_bytes(bytes))
+    }
+
+    fn read_str(&mut self) -> Result<&'a str, LoadingError> {
+        let len = self.read_u32()? as usize;
+
+        if self.data.len() - self.pos < len {
+            return Err(invalid_cache("truncated data"));
+        }
+
+        let bytes = &self.data[self.pos..self.pos + len];
+        self.pos += len;
+
+        str::from_utf8(bytes).map_err(|_| invalid_cache("malformed UTF-8"))
+    }
+
+    fn read_opt_str(&mut self) -> Result<Option<&'a str>, LoadingError> {
+        match self.read_tag() {
+            Some(0) => Ok(None),
+            Some(1) => Ok(Some(self.read_str()?)),
+            _ => Err(invalid_cache("malformed optional string")),
+        }
+    }
+
+    fn read_qual_name(&mut self) -> Result<QualName, LoadingError> {
+        let prefix = self.read_opt_str()?;
+        let ns = self.read_str()?;
+        let local = self.read_str()?;
+
+        Ok(QualName::new(
+            prefix.map(Prefix::from),
+            Namespace::from(ns),
+            LocalName::from(local),
+        ))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use markup5ever::{expanded_name, local_name};
+
+    #[test]
+    fn records_round_trip() {
+        let mut recorder = EventRecorder::new();
+
+        let name = QualName::new(None, ns!(svg), local_name!("rect"));
+        let attrs = vec![(
+            QualName::new(None, ns!(), local_name!("width")),
+            "100".to_string(),
+        )];
+        let pairs: Vec<_> = attrs.iter().map(|(q, v)| (q.clone(), v.as_str())).collect();
+
+        recorder.start_element(&name, &PropertyBag::new_from_pairs(&pairs));
+        recorder.characters("hello");
+        recorder.end_element();
+
+        let data = recorder.into_bytes();
+
+        let mut reader = EventReader::new(&data).unwrap();
+
+        assert_eq!(reader.read_tag(), Some(TAG_START_ELEMENT));
+        assert_eq!(reader.read_qual_name().unwrap().expanded(), name.expanded());
+        assert_eq!(reader.read_u32().unwrap(), 1);
+        assert_eq!(
+            reader.read_qual_name().unwrap().expanded(),
+            expanded_name!("", "width")
+        );
+        assert_eq!(reader.read_str().unwrap(), "100");
+
+        assert_eq!(reader.read_tag(), Some(TAG_CHARACTERS));
+        assert_eq!(reader.read_str().unwrap(), "hello");
+
+        assert_eq!(reader.read_tag(), Some(TAG_END_ELEMENT));
+        assert_eq!(reader.read_tag(), None);
+    }
+
+    #[test]
+    fn rejects_version_mismatch() {
+        let mut data = EventRecorder::new().into_bytes();
+
+        // Corrupt the version field.
+        let version_ofs = MAGIC.len();
+        data[version_ofs] = 0xff;
+
+        assert!(EventReader::new(&data).is_err());
+    }
+
+    #[test]
+    fn rejects_garbage() {
+        assert!(EventReader::new(b"not a cache file").is_err());
+        assert!(EventReader::new(b"").is_err());
+    }
+}
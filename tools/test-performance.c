@@ -2,6 +2,8 @@
 /* vim: set sw=4 sts=4 ts=4 expandtab: */
 /*
 
+   test-performance.c: Corpus-driven benchmark harness for librsvg.
+
    This library is free software; you can redistribute it and/or
    modify it under the terms of the GNU Lesser General Public
    License as published by the Free Software Foundation; either
@@ -17,13 +19,334 @@
    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 */
 
+/* Takes SVG files, or directories containing SVG files, and reports
+ * per-phase timings with simple statistics over repeated runs:
+ *
+ *   parse   - rsvg_handle_new_from_stream_sync on an in-memory stream
+ *   measure - rsvg_handle_get_dimensions (CSS cascade plus geometry)
+ *   render  - rsvg_handle_render_cairo to an image surface
+ *
+ * Each phase is measured at the public API boundary, so "measure"
+ * includes everything that has to happen after parsing before geometry
+ * can be reported, and "render" is the incremental cost of actually
+ * drawing.  With --output the results are also written as JSON, so runs
+ * can be compared across releases.
+ */
+
+#define RSVG_DISABLE_DEPRECATION_WARNINGS
+
 #include "config.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include <glib.h>
+#include <glib/gi18n.h>
+#include <gio/gio.h>
+
+#include "librsvg/rsvg.h"
+
+typedef struct {
+    double mean;
+    double median;
+    double min;
+    double max;
+    double stddev;
+} Stats;
+
+static int
+compare_doubles (const void *a, const void *b)
+{
+    double da = *(const double *) a;
+    double db = *(const double *) b;
+
+    return (da > db) - (da < db);
+}
+
+static void
+compute_stats (double *samples, int count, Stats *stats)
+{
+    double sum = 0.0, sq_sum = 0.0;
+    int i;
+
+    qsort (samples, count, sizeof (double), compare_doubles);
+
+    for (i = 0; i < count; i++) {
+        sum += samples[i];
+        sq_sum += samples[i] * samples[i];
+    }
+
+    stats->mean = sum / count;
+    stats->min = samples[0];
+    stats->max = samples[count - 1];
+
+    if (count % 2 == 0)
+        stats->median = (samples[count / 2 - 1] + samples[count / 2]) / 2.0;
+    else
+        stats->median = samples[count / 2];
+
+    if (count > 1)
+        stats->stddev = sqrt ((sq_sum - sum * sum / count) / (count - 1));
+    else
+        stats->stddev = 0.0;
+}
+
+static void
+append_stats_json (GString *json, const char *phase, const Stats *stats)
+{
+    g_string_append_printf (json,
+                            "      \"%s\": { \"mean\": %g, \"median\": %g, "
+                            "\"min\": %g, \"max\": %g, \"stddev\": %g }",
+                            phase,
+                            stats->mean, stats->median,
+                            stats->min, stats->max, stats->stddev);
+}
+
+static gboolean
+benchmark_file (const char *filename,
+                int count,
+                int warmup,
+                GString *json)
+{
+    char *contents = NULL;
+    gsize length = 0;
+    GError *error = NULL;
+    double *parse_samples, *measure_samples, *render_samples;
+    Stats parse_stats, measure_stats, render_stats;
+    cairo_surface_t *surface = NULL;
+    cairo_t *cr = NULL;
+    int i;
+
+    if (!g_file_get_contents (filename, &contents, &length, &error)) {
+        g_printerr (_("Error reading %s: %s\n"), filename, error->message);
+        g_error_free (error);
+        return FALSE;
+    }
+
+    parse_samples = g_new (double, count);
+    measure_samples = g_new (double, count);
+    render_samples = g_new (double, count);
+
+    for (i = -warmup; i < count; i++) {
+        GInputStream *stream;
+        RsvgHandle *handle;
+        RsvgDimensionData dimensions;
+        GTimer *timer = g_timer_new ();
+        double parse_elapsed, measure_elapsed, render_elapsed;
+
+        stream = g_memory_input_stream_new_from_data (contents, length, NULL);
+
+        g_timer_start (timer);
+        handle = rsvg_handle_new_from_stream_sync (stream, NULL,
+                                                   RSVG_HANDLE_FLAGS_NONE,
+                                                   NULL, &error);
+        parse_elapsed = g_timer_elapsed (timer, NULL);
+
+        g_object_unref (stream);
+
+        if (handle == NULL) {
+            g_printerr (_("Error parsing %s: %s\n"), filename, error->message);
+            g_error_free (error);
+            g_timer_destroy (timer);
+            g_free (parse_samples);
+            g_free (measure_samples);
+            g_free (render_samples);
+            g_free (contents);
+            return FALSE;
+        }
+
+        g_timer_start (timer);
+        rsvg_handle_get_dimensions (handle, &dimensions);
+        measure_elapsed = g_timer_elapsed (timer, NULL);
+
+        if (dimensions.width == 0 || dimensions.height == 0) {
+            g_printerr (_("The SVG %s has no dimensions\n"), filename);
+            g_object_unref (handle);
+            g_timer_destroy (timer);
+            g_free (parse_samples);
+            g_free (measure_samples);
+            g_free (render_samples);
+            g_free (contents);
+            return FALSE;
+        }
+
+        if (surface == NULL) {
+            surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+                                                  dimensions.width,
+                                                  dimensions.height);
+            cr = cairo_create (surface);
+        }
 
-#include "rsvg-tools-main.h"
+        g_timer_start (timer);
+        rsvg_handle_render_cairo (handle, cr);
+        render_elapsed = g_timer_elapsed (timer, NULL);
+
+        g_object_unref (handle);
+        g_timer_destroy (timer);
+
+        if (i >= 0) {
+            parse_samples[i] = parse_elapsed;
+            measure_samples[i] = measure_elapsed;
+            render_samples[i] = render_elapsed;
+        }
+    }
+
+    if (cr)
+        cairo_destroy (cr);
+    if (surface)
+        cairo_surface_destroy (surface);
+
+    compute_stats (parse_samples, count, &parse_stats);
+    compute_stats (measure_samples, count, &measure_stats);
+    compute_stats (render_samples, count, &render_stats);
+
+    g_print ("%-50s parse %10.6fs  measure %10.6fs  render %10.6fs\n",
+             filename, parse_stats.mean, measure_stats.mean, render_stats.mean);
+
+    if (json) {
+        char *escaped = g_strescape (filename, NULL);
+
+        if (json->len > 0)
+            g_string_append (json, ",\n");
+
+        g_string_append_printf (json, "    {\n      \"file\": \"%s\",\n", escaped);
+        append_stats_json (json, "parse", &parse_stats);
+        g_string_append (json, ",\n");
+        append_stats_json (json, "measure", &measure_stats);
+        g_string_append (json, ",\n");
+        append_stats_json (json, "render", &render_stats);
+        g_string_append (json, "\n    }");
+
+        g_free (escaped);
+    }
+
+    g_free (parse_samples);
+    g_free (measure_samples);
+    g_free (render_samples);
+    g_free (contents);
+
+    return TRUE;
+}
+
+static void
+collect_corpus (const char *arg, GPtrArray *files)
+{
+    if (g_file_test (arg, G_FILE_TEST_IS_DIR)) {
+        GDir *dir;
+        const char *entry;
+
+        dir = g_dir_open (arg, 0, NULL);
+        if (dir == NULL) {
+            g_printerr (_("Could not open directory %s\n"), arg);
+            return;
+        }
+
+        while ((entry = g_dir_read_name (dir)) != NULL) {
+            if (g_str_has_suffix (entry, ".svg") || g_str_has_suffix (entry, ".svgz"))
+                g_ptr_array_add (files, g_build_filename (arg, entry, NULL));
+        }
+
+        g_dir_close (dir);
+    } else {
+        g_ptr_array_add (files, g_strdup (arg));
+    }
+}
 
 int
 main (int argc, char **argv)
 {
-    return rsvg_tools_main(&argc, &argv);
+    GOptionContext *g_option_context;
+    int count = 10;
+    int warmup = 2;
+    int bVersion = 0;
+    char *output = NULL;
+    char **args = NULL;
+    GError *error = NULL;
+    GPtrArray *files;
+    GString *json = NULL;
+    gboolean success = TRUE;
+    guint i;
+
+    GOptionEntry options_table[] = {
+        {"count", 'c', 0, G_OPTION_ARG_INT, &count,
+         N_("number of measured runs per file [optional; defaults to 10]"), N_("<int>")},
+        {"warmup", 0, 0, G_OPTION_ARG_INT, &warmup,
+         N_("number of unmeasured warm-up runs per file [optional; defaults to 2]"), N_("<int>")},
+        {"output", 'o', 0, G_OPTION_ARG_FILENAME, &output,
+         N_("write results as JSON to a file [optional]"), NULL},
+        {"version", 'v', 0, G_OPTION_ARG_NONE, &bVersion,
+         N_("show version information"), NULL},
+        {G_OPTION_REMAINING, 0, 0, G_OPTION_ARG_FILENAME_ARRAY, &args, NULL,
+         N_("[FILE or DIRECTORY...]")},
+        {NULL}
+    };
+
+    g_option_context = g_option_context_new (_("- SVG performance harness"));
+    g_option_context_add_main_entries (g_option_context, options_table, NULL);
+    g_option_context_set_help_enabled (g_option_context, TRUE);
+    if (!g_option_context_parse (g_option_context, &argc, &argv, &error)) {
+        g_printerr ("%s\n", error->message);
+        exit (EXIT_FAILURE);
+    }
+
+    g_option_context_free (g_option_context);
+
+    if (bVersion != 0) {
+        g_print ("test-performance version %s\n", VERSION);
+        exit (EXIT_SUCCESS);
+    }
+
+    if (count < 1 || warmup < 0) {
+        g_printerr (_("Invalid --count or --warmup\n"));
+        exit (EXIT_FAILURE);
+    }
+
+    if (args == NULL) {
+        g_printerr (_("Must specify SVG files or directories\n"));
+        exit (EXIT_FAILURE);
+    }
+
+    files = g_ptr_array_new_with_free_func (g_free);
+    for (i = 0; args[i] != NULL; i++)
+        collect_corpus (args[i], files);
+
+    if (files->len == 0) {
+        g_printerr (_("No SVG files found\n"));
+        exit (EXIT_FAILURE);
+    }
+
+    if (output != NULL)
+        json = g_string_new (NULL);
+
+    for (i = 0; i < files->len; i++) {
+        if (!benchmark_file (g_ptr_array_index (files, i), count, warmup, json))
+            success = FALSE;
+    }
+
+    if (json != NULL) {
+        GString *document = g_string_new (NULL);
+
+        g_string_append_printf (document,
+                                "{\n  \"version\": \"%s\",\n  \"count\": %d,\n"
+                                "  \"unit\": \"seconds\",\n  \"files\": [\n",
+                                VERSION, count);
+        g_string_append (document, json->str);
+        g_string_append (document, "\n  ]\n}\n");
+
+        if (!g_file_set_contents (output, document->str, document->len, &error)) {
+            g_printerr (_("Error writing %s: %s\n"), output, error->message);
+            success = FALSE;
+        }
+
+        g_string_free (document, TRUE);
+        g_string_free (json, TRUE);
+    }
+
+    g_ptr_array_free (files, TRUE);
+    g_strfreev (args);
+    g_free (output);
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
 }